@@ -0,0 +1,120 @@
+/**
+ * @file parse_bench.cpp
+ * 
+ * @brief Benchmark measuring lexing and parsing throughput on a synthetic
+ *        corpus built from the constructs in the README examples.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include "ast.hpp"
+#include "parser.hpp"
+#include "token_buffer.hpp"
+#include "tokenizer.hpp"
+
+namespace {
+
+    constexpr const char* NAMES[] = {"value", "count", "next", "node", "total", "index", "left", "right"};
+    constexpr const char* TYPES[] = {"int", "float", "bool", "string", "array<int>", "Widget"};
+    constexpr const char* OPERATORS[] = {"+", "-", "*", "/", "==", "<", ">=", "&&"};
+
+    /**
+     * @brief Builds a random expression of bounded depth
+     */
+    std::string expression(std::mt19937& rng, int depth) {
+        const auto pick = [&](auto& list) { return std::string(list[rng() % std::size(list)]); };
+        switch (depth <= 0 ? rng() % 2 : rng() % 5) {
+            case 0: return pick(NAMES);
+            case 1: return std::to_string(rng() % 1000);
+            case 2: return "(" + expression(rng, depth - 1) + " " + pick(OPERATORS) + " " + expression(rng, depth - 1) + ")";
+            case 3: return pick(NAMES) + "(" + expression(rng, depth - 1) + ", " + expression(rng, depth - 1) + ")";
+            default: return expression(rng, depth - 1) + " " + pick(OPERATORS) + " " + expression(rng, depth - 1);
+        }
+    }
+
+    /**
+     * @brief Builds a source file of at least `size` bytes from classes,
+     *        functions, loops and lambdas
+     * 
+     * @param[in] size Minimum size in bytes
+     * @param[in] seed Seed for the generator, so runs are comparable
+     */
+    std::string generateCorpus(std::size_t size, unsigned seed) {
+        std::mt19937 rng(seed);
+        const auto pick = [&](auto& list) { return std::string(list[rng() % std::size(list)]); };
+        std::string source;
+        source.reserve(size + 4096);
+        for (std::size_t unit = 0; source.size() < size; ++unit) {
+            const std::string name = "Thing" + std::to_string(unit);
+            source += "// Generated class " + name + "\n";
+            source += "class " + name + " {\n";
+            source += "    " + name + "();\n";
+            source += "    " + name + ":fromArray(array<int>);\n";
+            source += "    private " + pick(TYPES) + " " + pick(NAMES) + " = " + expression(rng, 2) + ";\n";
+            source += "    public " + pick(TYPES) + " compute(int n, " + pick(TYPES) + " other) {\n";
+            source += "        int result = " + expression(rng, 3) + ";\n";
+            source += "        while (result < n) {\n";
+            source += "            result = result + " + expression(rng, 2) + ";\n";
+            source += "        }\n";
+            source += "        if (" + expression(rng, 2) + ") {\n";
+            source += "            return result;\n";
+            source += "        } else {\n";
+            source += "            return " + expression(rng, 3) + ";\n";
+            source += "        }\n";
+            source += "    }\n";
+            source += "}\n\n";
+            source += "/* Free function with a lambda */\n";
+            source += "int apply" + name + "(function<int>(int) step, int seed) {\n";
+            source += "    step = (int n) => { return n * 2; };\n";
+            source += "    return step(seed) + " + expression(rng, 3) + ";\n";
+            source += "}\n\n";
+        }
+        return source;
+    }
+}
+
+int main(int argc, char** argv) {
+
+    // Corpus size in MiB and number of timed runs, keeping the fastest
+    const std::size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    const int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+    constexpr unsigned SEED = 1234;
+
+    const std::string source = generateCorpus(mib << 20, SEED);
+    imperium_lang::TokenBuffer tokens{};
+    imperium_lang::Parser parser{};
+    imperium_lang::Ast ast{};
+    double bestLex = -1.0;
+    double bestParse = -1.0;
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        if (imperium_lang::Tokenizer::tokenize(source, tokens, nullptr, imperium_lang::TriviaMode::Skip) != 0) {
+            std::cerr << "Error: Tokenization failed.\n";
+            return -1;
+        }
+        const auto lexed = std::chrono::steady_clock::now();
+        if (parser.parse(source, tokens, ast) != 0) {
+            std::cerr << "Error: Parsing failed.\n";
+            return -1;
+        }
+        const auto parsed = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> lexSeconds = lexed - start;
+        const std::chrono::duration<double> parseSeconds = parsed - lexed;
+        bestLex = bestLex < 0.0 ? lexSeconds.count() : std::min(bestLex, lexSeconds.count());
+        bestParse = bestParse < 0.0 ? parseSeconds.count() : std::min(bestParse, parseSeconds.count());
+    }
+
+    const double megabytes = static_cast<double>(source.size()) / 1e6;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Corpus: " << source.size() << " bytes, " << tokens.size() << " tokens, " << ast.size() << " nodes\n";
+    std::cout << "Lex:   " << megabytes / bestLex << " MB/s\n";
+    std::cout << "Parse: " << megabytes / bestParse << " MB/s\n";
+    std::cout << "Total: " << megabytes / (bestLex + bestParse) << " MB/s\n";
+
+    return 0;
+}
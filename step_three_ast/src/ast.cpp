@@ -0,0 +1,290 @@
+/**
+ * @file ast.cpp
+ * 
+ * @brief Implementation file for the index-based abstract syntax tree
+ */
+
+#include "ast.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Allow the use of string_view literals
+using namespace std::literals::string_view_literals;
+
+namespace {
+    constexpr std::array NODE_KIND_NAMES = {
+        "module"sv, "class"sv, "function"sv, "parameter"sv, "variable"sv, "type"sv,
+        "function-type"sv, "type-parameters"sv, "block"sv, "if"sv, "while"sv, "do-while"sv, "for"sv,
+        "return"sv, "expression"sv, "identifier"sv, "number"sv, "string"sv, "char"sv,
+        "unary"sv, "binary"sv, "call"sv, "index"sv, "member"sv, "lambda"sv,
+        "list"sv, "continuation"sv,
+    };
+    static_assert(NODE_KIND_NAMES.size() == static_cast<std::size_t>(imperium_lang::NodeKind::NodeKindCount),
+        "Every node kind needs a name");
+
+    constexpr std::array OPERATOR_NAMES = {
+        ""sv,
+        "+"sv, "-"sv, "*"sv, "/"sv, "%"sv,
+        "<"sv, ">"sv, "<="sv, ">="sv, "=="sv, "!="sv,
+        "!"sv, "&&"sv, "||"sv,
+        "&"sv, "|"sv, "^"sv, "~"sv, "<<"sv, ">>"sv,
+        "="sv, "+="sv, "-="sv, "*="sv, "/="sv, "%="sv,
+        "-"sv, "::"sv,
+    };
+    static_assert(OPERATOR_NAMES.size() == static_cast<std::size_t>(imperium_lang::Operator::Scope) + 1,
+        "Every operator needs a spelling");
+
+    /**
+     * @brief Header at the start of a tree dump
+     */
+    struct AstDumpHeader {
+        std::array<char, 4> magic{'I', 'A', 'S', 'T'};
+        std::uint32_t version = 1;
+        std::uint32_t nodeCount = 0;
+        std::uint32_t childCount = 0;
+        std::uint32_t root = imperium_lang::NO_NODE;
+        std::uint32_t sourceSize = 0;
+    };
+
+    constexpr std::array FLAG_NAMES = {
+        "public"sv, "private"sv, "protected"sv, "static"sv, "const"sv, "final"sv,
+        "signal"sv, "derived"sv, "continuation"sv, "constructor"sv, "named-constructor"sv,
+    };
+
+    /**
+     * @brief Whether a node's name is worth printing
+     * 
+     * @param[in] kind The node's kind
+     */
+    constexpr bool printsName(imperium_lang::NodeKind kind) {
+        using imperium_lang::NodeKind;
+        switch (kind) {
+            case NodeKind::ClassDecl: case NodeKind::FunctionDecl: case NodeKind::Parameter:
+            case NodeKind::VariableDecl: case NodeKind::TypeName: case NodeKind::FunctionType:
+            case NodeKind::Identifier: case NodeKind::NumberLiteral: case NodeKind::StringLiteral:
+            case NodeKind::CharLiteral: case NodeKind::Member:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Writes a node and everything below it
+     * 
+     * @param[in] ast The tree
+     * @param[in] id The node to write. May be `NO_NODE`.
+     * @param[in] depth How far to indent the node
+     * @param[in, out] out The stream to write to
+     */
+    void printNode(const imperium_lang::Ast& ast, imperium_lang::NodeId id, std::size_t depth, std::ostream& out) {
+        using imperium_lang::NO_NODE;
+        out << std::string(depth * 2, ' ');
+        if (id == NO_NODE) {
+            out << "-\n";
+            return;
+        }
+        const auto& node = ast.node(id);
+        out << imperium_lang::nodeKindToString(node.kind);
+        if (node.op != imperium_lang::Operator::None) {
+            out << " " << imperium_lang::operatorToString(node.op);
+        }
+        if (printsName(node.kind) && node.length != 0) {
+            out << " " << ast.name(id);
+        }
+        for (std::size_t bit = 0; bit < FLAG_NAMES.size(); ++bit) {
+            if ((node.flags & (1u << bit)) != 0) {
+                out << " [" << FLAG_NAMES[bit] << "]";
+            }
+        }
+        out << "\n";
+        if (imperium_lang::NODE_HAS_LIST[static_cast<std::size_t>(node.kind)]) {
+            for (const auto child : ast.children(id)) {
+                printNode(ast, child, depth + 1, out);
+            }
+        } else {
+            for (const auto child : {node.first, node.second}) {
+                if (child != NO_NODE) {
+                    printNode(ast, child, depth + 1, out);
+                }
+            }
+        }
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Drops every node and starts a tree over another source
+     * 
+     * @param[in] source The source buffer names refer into. Must
+     *            outlive the tree.
+     */
+    void Ast::reset(std::string_view source) {
+
+        // Nodes are trivially destructible, so this does not touch them
+        sourceText = source;
+        nodes.clear();
+        childIds.clear();
+        rootId = NO_NODE;
+    }
+
+    /**
+     * @brief Adds a node
+     * 
+     * @param[in] node The node to add
+     * @return The new node's index
+     */
+    NodeId Ast::add(const Node& node) {
+        nodes.push_back(node);
+        return static_cast<NodeId>(nodes.size() - 1);
+    }
+
+    /**
+     * @brief Adds a node of a list kind along with its children
+     * 
+     * @param[in] node The node to add. Its `first` and `second` are set
+     *            from the list.
+     * @param[in] children The node's children, in order
+     * @return The new node's index
+     */
+    NodeId Ast::addList(Node node, std::span<const NodeId> children) {
+        node.first = static_cast<NodeId>(childIds.size());
+        node.second = static_cast<NodeId>(children.size());
+        childIds.insert(childIds.end(), children.begin(), children.end());
+        return add(node);
+    }
+
+    /**
+     * @brief Provides the children of a list kind node
+     * 
+     * @param[in] id Node index, below `size()`
+     * @return The children, or nothing if the kind has no list
+     */
+    std::span<const NodeId> Ast::children(NodeId id) const {
+        const Node& parent = nodes[id];
+        if (!NODE_HAS_LIST[static_cast<std::size_t>(parent.kind)]) {
+            return {};
+        }
+        return std::span<const NodeId>(childIds).subspan(parent.first, parent.second);
+    }
+
+    /**
+     * @brief Writes the tree in a flat binary form that `readDump` reads
+     *        back
+     * 
+     * @param[in, out] out The stream to write to
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Write Error
+     */
+    int Ast::writeDump(std::ostream& out) const {
+
+        AstDumpHeader header{};
+        header.nodeCount = static_cast<std::uint32_t>(nodes.size());
+        header.childCount = static_cast<std::uint32_t>(childIds.size());
+        header.root = rootId;
+        header.sourceSize = static_cast<std::uint32_t>(sourceText.size());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(nodes.data()), static_cast<std::streamsize>(nodes.size() * sizeof(Node)));
+        out.write(reinterpret_cast<const char*>(childIds.data()), static_cast<std::streamsize>(childIds.size() * sizeof(NodeId)));
+        if (!out) {
+            std::cerr << "Error: Failed to write tree dump.\n";
+            return -2;
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Replaces the tree with one read from a dump
+     * 
+     * Every index and name in the dump is checked, so a damaged dump is
+     * rejected rather than producing a tree that reads out of bounds.
+     * 
+     * @param[in] dump Bytes written by `writeDump`
+     * @param[in] source The source buffer the dumped tree was parsed
+     *            from. Must outlive the tree.
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 `dump` is not a well formed tree over `source`
+     */
+    int Ast::readDump(std::string_view dump, std::string_view source) {
+
+        reset(source);
+        AstDumpHeader header{};
+        if (dump.size() < sizeof(header)) {
+            return -1;
+        }
+        std::memcpy(&header, dump.data(), sizeof(header));
+        if (header.magic != AstDumpHeader{}.magic || header.version != AstDumpHeader{}.version
+                || header.sourceSize != source.size()
+                || dump.size() != sizeof(header) + std::size_t{header.nodeCount} * sizeof(Node) + std::size_t{header.childCount} * sizeof(NodeId)) {
+            return -1;
+        }
+        nodes.resize(header.nodeCount);
+        childIds.resize(header.childCount);
+        std::memcpy(nodes.data(), dump.data() + sizeof(header), nodes.size() * sizeof(Node));
+        std::memcpy(childIds.data(), dump.data() + sizeof(header) + nodes.size() * sizeof(Node), childIds.size() * sizeof(NodeId));
+        rootId = header.root;
+
+        // Children always come before their parent, which also rules out cycles
+        bool valid = rootId == NO_NODE || rootId < nodes.size();
+        for (std::size_t i = 0; valid && i < nodes.size(); ++i) {
+            const Node& node = nodes[i];
+            const auto kind = static_cast<std::size_t>(node.kind);
+            const auto validChild = [&](NodeId child) { return child == NO_NODE || child < i; };
+            valid = kind < NODE_HAS_LIST.size() && node.op <= Operator::Scope
+                && std::size_t{node.offset} + node.length <= source.size();
+            if (valid && NODE_HAS_LIST[kind]) {
+                valid = std::size_t{node.first} + node.second <= childIds.size()
+                    && std::all_of(childIds.begin() + node.first, childIds.begin() + node.first + node.second, validChild);
+            } else if (valid) {
+                valid = validChild(node.first) && validChild(node.second);
+            }
+        }
+        if (!valid) {
+            reset(source);
+            return -1;
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Provides the string name of a `NodeKind`
+     * 
+     * @param[in] kind The `NodeKind` to get the name of
+     * @return The string name of the `NodeKind`
+     */
+    std::string_view nodeKindToString(NodeKind kind) {
+        const auto index = static_cast<std::size_t>(kind);
+        return index < NODE_KIND_NAMES.size() ? NODE_KIND_NAMES[index] : "invalid"sv;
+    }
+
+    /**
+     * @brief Provides the source spelling of an `Operator`
+     * 
+     * @param[in] op The `Operator` to spell
+     * @return The operator as written in source, or an empty view for `None`
+     */
+    std::string_view operatorToString(Operator op) {
+        const auto index = static_cast<std::size_t>(op);
+        return index < OPERATOR_NAMES.size() ? OPERATOR_NAMES[index] : ""sv;
+    }
+
+    /**
+     * @brief Writes a tree as indented text, one node per line
+     * 
+     * @param[in] ast The tree to write
+     * @param[in, out] out The stream to write to
+     */
+    void printTree(const Ast& ast, std::ostream& out) {
+        if (ast.root() != NO_NODE) {
+            printNode(ast, ast.root(), 0, out);
+        }
+    }
+
+}
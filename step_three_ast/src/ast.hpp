@@ -0,0 +1,269 @@
+/**
+ * @file ast.hpp
+ * 
+ * @brief Include file for the index-based abstract syntax tree
+ */
+
+#ifndef AST_HPP
+#define AST_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace imperium_lang {
+
+    using NodeId = std::uint32_t;
+    constexpr NodeId NO_NODE = UINT32_MAX;
+
+    /**
+     * @brief The kinds of AST node
+     * 
+     * Each kind says how its node's `first` and `second` fields are used.
+     * List kinds keep their children in the tree's child array, with
+     * `first` the start of the run and `second` its length. Slots in a
+     * child list may hold `NO_NODE` when the part is absent.
+     */
+    enum class NodeKind : std::uint8_t {
+        Module,             // List of declarations
+        ClassDecl,          // Name. List: type parameters, then members.
+        FunctionDecl,       // Name. List: return type, body, then parameters.
+        Parameter,          // Name. `first` type, `second` default value.
+        VariableDecl,       // Name. `first` type, `second` initializer.
+        TypeName,           // Name. List of type arguments.
+        FunctionType,       // Name. List: return type, then parameter types.
+        TypeParameters,     // List of `Identifier`s
+        Block,              // List of statements
+        If,                 // List: condition, then branch, else branch
+        While,              // `first` condition, `second` body
+        DoWhile,            // `first` body, `second` condition
+        For,                // List: initializer, condition, step, body
+        Return,             // `first` value
+        ExpressionStatement,// `first` expression
+        Identifier,         // Name
+        NumberLiteral,      // Name is the literal's text
+        StringLiteral,      // Name is the literal's text, quotes included
+        CharLiteral,        // Name is the literal's text, quotes included
+        Unary,              // `op`. `first` operand.
+        Binary,             // `op`. `first` left, `second` right.
+        Call,               // List: callee, then arguments
+        Index,              // `first` indexed value, `second` index
+        Member,             // Name of the member. `first` object.
+        Lambda,             // List: body, then parameters
+        ListLiteral,        // List of elements
+        Continuation,       // List: bindings, entry point, arguments
+        NodeKindCount,
+    };
+
+    /**
+     * @brief Operators of `Unary` and `Binary` nodes
+     */
+    enum class Operator : std::uint8_t {
+        None,
+        Add, Subtract, Multiply, Divide, Modulo,
+        Less, Greater, LessEqual, GreaterEqual, Equal, NotEqual,
+        Not, LogicalAnd, LogicalOr,
+        BitAnd, BitOr, BitXor, BitNot, ShiftLeft, ShiftRight,
+        Assign, AddAssign, SubtractAssign, MultiplyAssign, DivideAssign, ModuloAssign,
+        Negate, Scope,
+    };
+
+    /**
+     * @brief Modifier flags of declarations
+     */
+    enum NodeFlag : std::uint16_t {
+        FlagPublic = 1 << 0,
+        FlagPrivate = 1 << 1,
+        FlagProtected = 1 << 2,
+        FlagStatic = 1 << 3,
+        FlagConst = 1 << 4,
+        FlagFinal = 1 << 5,
+        FlagSignal = 1 << 6,
+        FlagDerived = 1 << 7,
+        FlagContinuation = 1 << 8,
+        FlagConstructor = 1 << 9,
+        FlagNamedConstructor = 1 << 10,
+    };
+
+    /**
+     * @brief Whether each node kind keeps a child list
+     */
+    constexpr auto NODE_HAS_LIST = [] {
+        std::array<bool, static_cast<std::size_t>(NodeKind::NodeKindCount)> hasList{};
+        for (const auto kind : {NodeKind::Module, NodeKind::ClassDecl, NodeKind::FunctionDecl, NodeKind::TypeName,
+                NodeKind::FunctionType, NodeKind::TypeParameters, NodeKind::Block, NodeKind::If, NodeKind::For,
+                NodeKind::Call, NodeKind::Lambda, NodeKind::ListLiteral, NodeKind::Continuation}) {
+            hasList[static_cast<std::size_t>(kind)] = true;
+        }
+        return hasList;
+    }();
+
+    /**
+     * @brief One AST node
+     * 
+     * Names are not copied; `offset` and `length` locate the node's name or
+     * main token in the source buffer the tree was parsed from.
+     */
+    struct Node {
+        NodeKind kind;
+        Operator op = Operator::None;
+        std::uint16_t flags = 0;
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+        NodeId first = NO_NODE;
+        NodeId second = NO_NODE;
+    };
+    static_assert(sizeof(Node) == 20, "AST nodes should stay compact");
+
+    /**
+     * @brief An abstract syntax tree stored as flat arrays
+     * 
+     * Nodes refer to each other by 32-bit index rather than by pointer, and
+     * every child list is a run in one shared array. Nothing is freed node
+     * by node: `reset` drops the whole tree at once and keeps the storage
+     * for the next one.
+     */
+    class Ast {
+    private:
+        std::string_view sourceText;
+        std::vector<Node> nodes;
+        std::vector<NodeId> childIds;
+        NodeId rootId = NO_NODE;
+    public:
+        /**
+         * @brief Drops every node and starts a tree over another source
+         * 
+         * @param[in] source The source buffer names refer into. Must
+         *            outlive the tree.
+         */
+        void reset(std::string_view source);
+
+        /**
+         * @brief Adds a node
+         * 
+         * @param[in] node The node to add
+         * @return The new node's index
+         */
+        NodeId add(const Node& node);
+
+        /**
+         * @brief Adds a node of a list kind along with its children
+         * 
+         * @param[in] node The node to add. Its `first` and `second` are set
+         *            from the list.
+         * @param[in] children The node's children, in order
+         * @return The new node's index
+         */
+        NodeId addList(Node node, std::span<const NodeId> children);
+
+        /**
+         * @brief Sets the root of the tree
+         * 
+         * @param[in] id Index of the root node
+         */
+        void setRoot(NodeId id) { rootId = id; }
+
+        /**
+         * @brief Provides the root of the tree, or `NO_NODE` if it is unset
+         */
+        NodeId root() const { return rootId; }
+
+        /**
+         * @brief Provides the number of nodes
+         */
+        std::size_t size() const { return nodes.size(); }
+
+        /**
+         * @brief Provides the source buffer names refer into
+         */
+        std::string_view source() const { return sourceText; }
+
+        /**
+         * @brief Provides a node
+         * 
+         * @param[in] id Node index, below `size()`
+         */
+        const Node& node(NodeId id) const { return nodes[id]; }
+
+        /**
+         * @brief Provides a node for modification
+         * 
+         * @param[in] id Node index, below `size()`
+         */
+        Node& node(NodeId id) { return nodes[id]; }
+
+        /**
+         * @brief Provides the children of a list kind node
+         * 
+         * @param[in] id Node index, below `size()`
+         * @return The children, or nothing if the kind has no list
+         */
+        std::span<const NodeId> children(NodeId id) const;
+
+        /**
+         * @brief Provides the source text of a node's name or main token
+         * 
+         * @param[in] id Node index, below `size()`
+         */
+        std::string_view name(NodeId id) const {
+            return sourceText.substr(nodes[id].offset, nodes[id].length);
+        }
+
+        /**
+         * @brief Writes the tree in a flat binary form that `readDump` reads
+         *        back
+         * 
+         * The dump is a header followed by the node array and the child
+         * array exactly as they are held in memory, in host byte order.
+         * 
+         * @param[in, out] out The stream to write to
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Write Error
+         */
+        int writeDump(std::ostream& out) const;
+
+        /**
+         * @brief Replaces the tree with one read from a dump
+         * 
+         * @param[in] dump Bytes written by `writeDump`
+         * @param[in] source The source buffer the dumped tree was parsed
+         *            from. Must outlive the tree.
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 `dump` is not a well formed tree over `source`
+         */
+        int readDump(std::string_view dump, std::string_view source);
+    };
+
+    /**
+     * @brief Provides the string name of a `NodeKind`
+     * 
+     * @param[in] kind The `NodeKind` to get the name of
+     * @return The string name of the `NodeKind`
+     */
+    std::string_view nodeKindToString(NodeKind kind);
+
+    /**
+     * @brief Provides the source spelling of an `Operator`
+     * 
+     * @param[in] op The `Operator` to spell
+     * @return The operator as written in source, or an empty view for `None`
+     */
+    std::string_view operatorToString(Operator op);
+
+    /**
+     * @brief Writes a tree as indented text, one node per line
+     * 
+     * @param[in] ast The tree to write
+     * @param[in, out] out The stream to write to
+     */
+    void printTree(const Ast& ast, std::ostream& out);
+
+}
+
+#endif
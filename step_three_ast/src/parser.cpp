@@ -0,0 +1,1184 @@
+/**
+ * @file parser.cpp
+ * 
+ * @brief Implementation file for the single pass parser
+ */
+
+#include "parser.hpp"
+#include "source_map.hpp"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <span>
+
+// Allow the use of string_view literals
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    using imperium_lang::Keyword;
+    using imperium_lang::NO_NODE;
+    using imperium_lang::Node;
+    using imperium_lang::NodeId;
+    using imperium_lang::NodeKind;
+    using imperium_lang::Operator;
+    using imperium_lang::OperatorKind;
+
+    constexpr std::size_t LOOKAHEAD = 4;
+
+    /**
+     * @brief Provides the AST operator a binary or postfix use of an
+     *        operator token builds
+     * 
+     * @param[in] op The operator token's kind
+     * @return The AST operator, or `None` for `=>`
+     */
+    constexpr Operator astOperator(OperatorKind op) {
+        switch (op) {
+            case OperatorKind::Add: return Operator::Add;
+            case OperatorKind::Subtract: return Operator::Subtract;
+            case OperatorKind::Multiply: return Operator::Multiply;
+            case OperatorKind::Divide: return Operator::Divide;
+            case OperatorKind::Modulo: return Operator::Modulo;
+            case OperatorKind::Less: return Operator::Less;
+            case OperatorKind::Greater: return Operator::Greater;
+            case OperatorKind::LessEqual: return Operator::LessEqual;
+            case OperatorKind::GreaterEqual: return Operator::GreaterEqual;
+            case OperatorKind::Equal: return Operator::Equal;
+            case OperatorKind::NotEqual: return Operator::NotEqual;
+            case OperatorKind::Not: return Operator::Not;
+            case OperatorKind::LogicalAnd: return Operator::LogicalAnd;
+            case OperatorKind::LogicalOr: return Operator::LogicalOr;
+            case OperatorKind::BitAnd: return Operator::BitAnd;
+            case OperatorKind::BitOr: return Operator::BitOr;
+            case OperatorKind::BitXor: return Operator::BitXor;
+            case OperatorKind::BitNot: return Operator::BitNot;
+            case OperatorKind::ShiftLeft: return Operator::ShiftLeft;
+            case OperatorKind::ShiftRight: return Operator::ShiftRight;
+            case OperatorKind::Assign: return Operator::Assign;
+            case OperatorKind::AddAssign: return Operator::AddAssign;
+            case OperatorKind::SubtractAssign: return Operator::SubtractAssign;
+            case OperatorKind::MultiplyAssign: return Operator::MultiplyAssign;
+            case OperatorKind::DivideAssign: return Operator::DivideAssign;
+            case OperatorKind::ModuloAssign: return Operator::ModuloAssign;
+            case OperatorKind::Scope: return Operator::Scope;
+            default: return Operator::None;
+        }
+    }
+
+    /**
+     * @brief Binding power of each infix operator, 0 for operators that are
+     *        not infix
+     */
+    constexpr auto INFIX_POWER = [] {
+        std::array<std::uint8_t, static_cast<std::size_t>(OperatorKind::Arrow) + 1> power{};
+        const auto set = [&](std::uint8_t value, std::initializer_list<OperatorKind> ops) {
+            for (const auto op : ops) {
+                power[static_cast<std::size_t>(op)] = value;
+            }
+        };
+        set(1, {OperatorKind::Assign, OperatorKind::AddAssign, OperatorKind::SubtractAssign, OperatorKind::MultiplyAssign,
+            OperatorKind::DivideAssign, OperatorKind::ModuloAssign});
+        set(2, {OperatorKind::LogicalOr});
+        set(3, {OperatorKind::LogicalAnd});
+        set(4, {OperatorKind::BitOr});
+        set(5, {OperatorKind::BitXor});
+        set(6, {OperatorKind::BitAnd});
+        set(7, {OperatorKind::Equal, OperatorKind::NotEqual});
+        set(8, {OperatorKind::Less, OperatorKind::Greater, OperatorKind::LessEqual, OperatorKind::GreaterEqual});
+        set(9, {OperatorKind::ShiftLeft, OperatorKind::ShiftRight});
+        set(10, {OperatorKind::Add, OperatorKind::Subtract});
+        set(11, {OperatorKind::Multiply, OperatorKind::Divide, OperatorKind::Modulo});
+        set(13, {OperatorKind::Scope});
+        return power;
+    }();
+    constexpr std::uint8_t PREFIX_POWER = 12;
+    constexpr std::uint8_t POSTFIX_POWER = 13;
+
+    /**
+     * @brief Kinds of significant token the parser reads
+     */
+    enum class LexemeKind : std::uint8_t {
+        End,
+        Identifier,
+        Keyword,
+        Number,
+        String,
+        Char,
+        Operator,
+        Punct,
+        Unterminated,
+    };
+
+    /**
+     * @brief One significant token, with string and character literals
+     *        already joined into a single lexeme
+     */
+    struct Lexeme {
+        LexemeKind kind = LexemeKind::End;
+        OperatorKind op = OperatorKind::None;
+        Keyword keyword = Keyword::None;
+        char punct = 0;
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+    };
+
+    /**
+     * @brief Whether a reserved word names a type
+     * 
+     * @param[in] keyword The reserved word
+     */
+    constexpr bool isTypeKeyword(Keyword keyword) {
+        switch (keyword) {
+            case Keyword::Int: case Keyword::String: case Keyword::Bool: case Keyword::Char:
+            case Keyword::Float: case Keyword::Array: case Keyword::Bits: case Keyword::Ptr:
+            case Keyword::Ref: case Keyword::Function: case Keyword::CallbackT:
+            case Keyword::ContinuationT: case Keyword::RegexT:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Provides the flag a modifier reserved word sets
+     * 
+     * @param[in] keyword The reserved word
+     * @return The flag, or 0 if the word is not a modifier
+     */
+    constexpr std::uint16_t modifierFlag(Keyword keyword) {
+        switch (keyword) {
+            case Keyword::Public: return imperium_lang::FlagPublic;
+            case Keyword::Private: return imperium_lang::FlagPrivate;
+            case Keyword::Protected: return imperium_lang::FlagProtected;
+            case Keyword::Static: return imperium_lang::FlagStatic;
+            case Keyword::Const: return imperium_lang::FlagConst;
+            case Keyword::Final: return imperium_lang::FlagFinal;
+            case Keyword::Signal: return imperium_lang::FlagSignal;
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief State of one parse
+     * 
+     * Every parse method returns a status code: 0 on success and -1 on a
+     * parse error, which has already been reported.
+     */
+    class ParseState {
+    private:
+        std::string_view source;
+        const imperium_lang::TokenBuffer& tokens;
+        imperium_lang::Ast& ast;
+        std::vector<NodeId>& scratch;
+        std::size_t tokenIndex = 0;
+        std::array<Lexeme, LOOKAHEAD> ahead{};
+        std::size_t aheadStart = 0;
+        std::size_t aheadCount = 0;
+        std::size_t depth = 0;
+
+        /**
+         * @brief Reads the next significant lexeme from the tokens
+         */
+        Lexeme scan() {
+            const auto kinds = tokens.kinds();
+            while (tokenIndex < kinds.size()
+                    && (kinds[tokenIndex] == imperium_lang::Whitespace || kinds[tokenIndex] == imperium_lang::Comment)) {
+                ++tokenIndex;
+            }
+            if (tokenIndex == kinds.size() || kinds[tokenIndex] == imperium_lang::EndOfFile) {
+                return Lexeme{LexemeKind::End, OperatorKind::None, Keyword::None, 0, static_cast<std::uint32_t>(source.size()), 0};
+            }
+            const auto token = tokens[tokenIndex++];
+            Lexeme lexeme{LexemeKind::Identifier, OperatorKind::None, Keyword::None, 0,
+                static_cast<std::uint32_t>(token.offset), static_cast<std::uint32_t>(token.length)};
+            const std::string_view text = token.text(source);
+            switch (token.type) {
+                case imperium_lang::ReservedWord:
+                    lexeme.kind = LexemeKind::Keyword;
+                    lexeme.keyword = tokens.hasPayloads() ? token.keyword : imperium_lang::lookupKeyword(text);
+                    break;
+                case imperium_lang::Number:
+                    lexeme.kind = LexemeKind::Number;
+                    break;
+                case imperium_lang::OperatorSequence:
+                    lexeme.kind = LexemeKind::Operator;
+                    lexeme.op = tokens.hasPayloads() ? token.op : imperium_lang::lookupOperator(text);
+                    break;
+                case imperium_lang::Delimiter:
+                    if (text[0] == '"' || text[0] == '\'') {
+                        return scanQuoted(lexeme, text[0]);
+                    }
+                    lexeme.kind = LexemeKind::Punct;
+                    lexeme.punct = text[0];
+                    break;
+                default:
+                    break;
+            }
+            return lexeme;
+        }
+
+        /**
+         * @brief Joins the tokens of a string or character literal
+         * 
+         * @param[in] open Lexeme of the opening quote
+         * @param[in] quote The quote character
+         * @return The literal's lexeme, or an `Unterminated` lexeme
+         */
+        Lexeme scanQuoted(Lexeme open, char quote) {
+            const auto kinds = tokens.kinds();
+            const auto offsets = tokens.offsets();
+            for (; tokenIndex < kinds.size(); ++tokenIndex) {
+                const std::size_t at = offsets[tokenIndex];
+                if (kinds[tokenIndex] != imperium_lang::Delimiter || source[at] != quote) {
+                    continue;
+                }
+
+                // A quote after an odd run of backslashes is escaped
+                std::size_t slashes = 0;
+                while (at - slashes > open.offset + 1 && source[at - slashes - 1] == '\\') {
+                    ++slashes;
+                }
+                if (slashes % 2 == 0) {
+                    ++tokenIndex;
+                    open.kind = quote == '"' ? LexemeKind::String : LexemeKind::Char;
+                    open.length = static_cast<std::uint32_t>(at + 1 - open.offset);
+                    return open;
+                }
+            }
+            open.kind = LexemeKind::Unterminated;
+            return open;
+        }
+
+        /**
+         * @brief Provides a lexeme of lookahead without consuming it
+         * 
+         * @param[in] n How far ahead to look, below `LOOKAHEAD`
+         */
+        const Lexeme& peek(std::size_t n = 0) {
+            while (aheadCount <= n) {
+                ahead[(aheadStart + aheadCount) % LOOKAHEAD] = scan();
+                ++aheadCount;
+            }
+            return ahead[(aheadStart + n) % LOOKAHEAD];
+        }
+
+        /**
+         * @brief Consumes the current lexeme
+         * 
+         * @return The consumed lexeme
+         */
+        Lexeme advance() {
+            const Lexeme lexeme = peek();
+            aheadStart = (aheadStart + 1) % LOOKAHEAD;
+            --aheadCount;
+            return lexeme;
+        }
+
+        bool atPunct(char punct, std::size_t n = 0) {
+            const Lexeme& lexeme = peek(n);
+            return lexeme.kind == LexemeKind::Punct && lexeme.punct == punct;
+        }
+
+        bool atKeyword(Keyword keyword, std::size_t n = 0) {
+            const Lexeme& lexeme = peek(n);
+            return lexeme.kind == LexemeKind::Keyword && lexeme.keyword == keyword;
+        }
+
+        bool atOperator(OperatorKind op, std::size_t n = 0) {
+            const Lexeme& lexeme = peek(n);
+            return lexeme.kind == LexemeKind::Operator && lexeme.op == op;
+        }
+
+        /**
+         * @brief Whether lexeme `n + 1` starts right where lexeme `n` ends
+         */
+        bool adjacent(std::size_t n = 0) {
+            const Lexeme& first = peek(n);
+            return peek(n + 1).offset == first.offset + first.length;
+        }
+
+        /**
+         * @brief Consumes the `>` closing a list of type arguments
+         * 
+         * The `>>` closing two nested lists is split in two, leaving the
+         * second `>` as the current lexeme.
+         */
+        int expectClosingAngle() {
+            if (atOperator(OperatorKind::ShiftRight)) {
+                Lexeme& lexeme = ahead[aheadStart];
+                lexeme.op = OperatorKind::Greater;
+                ++lexeme.offset;
+                lexeme.length = 1;
+                return 0;
+            }
+            if (!atOperator(OperatorKind::Greater)) {
+                return fail("'>'"sv);
+            }
+            advance();
+            return 0;
+        }
+
+        std::string_view text(const Lexeme& lexeme) const {
+            return source.substr(lexeme.offset, lexeme.length);
+        }
+
+        /**
+         * @brief Reports a parse error at the current lexeme
+         * 
+         * @param[in] problem What went wrong
+         * @param[in] detail More about what went wrong
+         * @return -1
+         */
+        int report(std::string_view problem, std::string_view detail = {}) {
+            const auto location = imperium_lang::SourceMap(source).locate(peek().offset);
+            std::cerr << "Parse Error: " << problem << detail << " at line " << location.line << ", column " << location.column << ".\n";
+            return -1;
+        }
+
+        /**
+         * @brief Reports that the current lexeme is not what was expected
+         * 
+         * @param[in] expected What the parser expected to find
+         * @return -1
+         */
+        int fail(std::string_view expected) {
+            if (peek().kind == LexemeKind::Unterminated) {
+                return report("Unterminated literal"sv);
+            }
+            return report("Expected "sv, expected);
+        }
+
+        int expectPunct(char punct, std::string_view expected) {
+            if (!atPunct(punct)) {
+                return fail(expected);
+            }
+            advance();
+            return 0;
+        }
+
+        int expectIdentifier(Lexeme& name) {
+            if (peek().kind != LexemeKind::Identifier) {
+                return fail("a name"sv);
+            }
+            name = advance();
+            return 0;
+        }
+
+        /**
+         * @brief Adds a list node from the scratch entries above `mark`
+         */
+        NodeId finishList(Node node, std::size_t mark) {
+            const NodeId id = ast.addList(node, std::span<const NodeId>(scratch).subspan(mark));
+            scratch.resize(mark);
+            return id;
+        }
+
+        static Node named(NodeKind kind, const Lexeme& lexeme, std::uint16_t flags = 0) {
+            Node node{kind};
+            node.flags = flags;
+            node.offset = lexeme.offset;
+            node.length = lexeme.length;
+            return node;
+        }
+
+        /**
+         * @brief Guards against recursion deep enough to exhaust the stack
+         */
+        struct DepthGuard {
+            std::size_t& depth;
+            explicit DepthGuard(std::size_t& counter) : depth(counter) { ++depth; }
+            ~DepthGuard() { --depth; }
+        };
+
+        int checkDepth() {
+            if (depth > imperium_lang::Parser::MAX_DEPTH) {
+                return report("Nesting too deep"sv);
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Whether the current lexemes start a declaration rather than
+         *        an expression
+         */
+        bool startsDeclaration() {
+            const Lexeme& first = peek();
+            if (first.kind == LexemeKind::Keyword) {
+                return isTypeKeyword(first.keyword) || modifierFlag(first.keyword) != 0 || first.keyword == Keyword::Class;
+            }
+            if (first.kind != LexemeKind::Identifier) {
+                return false;
+            }
+            const Lexeme& second = peek(1);
+            if (second.kind == LexemeKind::Identifier || (second.kind == LexemeKind::Keyword && isTypeKeyword(second.keyword))) {
+                return true;
+            }
+            return atOperator(OperatorKind::Less, 1) && adjacent();
+        }
+
+        /**
+         * @brief Parses modifier reserved words and the contextual `derived`
+         * 
+         * @return The modifier flags
+         */
+        std::uint16_t parseModifiers() {
+            std::uint16_t flags = 0;
+            while (true) {
+                const Lexeme& lexeme = peek();
+                if (lexeme.kind == LexemeKind::Keyword && modifierFlag(lexeme.keyword) != 0) {
+                    flags |= modifierFlag(lexeme.keyword);
+                } else if (lexeme.kind == LexemeKind::Identifier && text(lexeme) == "derived"sv
+                        && (peek(1).kind == LexemeKind::Identifier || peek(1).kind == LexemeKind::Keyword)) {
+                    flags |= imperium_lang::FlagDerived;
+                } else {
+                    return flags;
+                }
+                advance();
+            }
+        }
+
+        /**
+         * @brief Parses a type such as `int`, `array<int>` or
+         *        `function<void>(ref<int>)`
+         */
+        int parseType(NodeId& out) {
+            const Lexeme& first = peek();
+            const bool typeWord = first.kind == LexemeKind::Identifier
+                || (first.kind == LexemeKind::Keyword && isTypeKeyword(first.keyword));
+            if (!typeWord) {
+                return fail("a type"sv);
+            }
+            DepthGuard guard(depth);
+            if (checkDepth() != 0) {
+                return -1;
+            }
+            const bool takesArguments = atOperator(OperatorKind::Less, 1) && adjacent();
+            const Lexeme name = advance();
+            const std::size_t mark = scratch.size();
+            if (takesArguments) {
+                advance();
+                while (true) {
+                    NodeId argument;
+                    if (parseType(argument) != 0) {
+                        return -1;
+                    }
+                    scratch.push_back(argument);
+                    if (!atPunct(',')) {
+                        break;
+                    }
+                    advance();
+                }
+                if (expectClosingAngle() != 0) {
+                    return -1;
+                }
+            }
+            if (name.kind == LexemeKind::Keyword && name.keyword == Keyword::Function) {
+                if (scratch.size() == mark) {
+                    scratch.push_back(NO_NODE);
+                } else if (scratch.size() > mark + 1) {
+                    return fail("a single return type"sv);
+                }
+                if (atPunct('(')) {
+                    advance();
+                    while (!atPunct(')')) {
+                        NodeId parameter;
+                        if (parseType(parameter) != 0) {
+                            return -1;
+                        }
+                        scratch.push_back(parameter);
+                        if (!atPunct(',')) {
+                            break;
+                        }
+                        advance();
+                    }
+                    if (expectPunct(')', "')'"sv) != 0) {
+                        return -1;
+                    }
+                }
+                out = finishList(named(NodeKind::FunctionType, name), mark);
+                return 0;
+            }
+            out = finishList(named(NodeKind::TypeName, name), mark);
+            return 0;
+        }
+
+        /**
+         * @brief Parses a parenthesized parameter list onto the scratch stack
+         */
+        int parseParameters() {
+            if (expectPunct('(', "'('"sv) != 0) {
+                return -1;
+            }
+            while (!atPunct(')')) {
+                NodeId type;
+                if (parseType(type) != 0) {
+                    return -1;
+                }
+
+                // Parameters of prototypes may leave out their name
+                Node parameter{NodeKind::Parameter};
+                parameter.offset = ast.node(type).offset;
+                if (peek().kind == LexemeKind::Identifier) {
+                    parameter = named(NodeKind::Parameter, advance());
+                }
+                parameter.first = type;
+                if (atOperator(OperatorKind::Assign)) {
+                    advance();
+                    if (parseExpression(1, parameter.second) != 0) {
+                        return -1;
+                    }
+                }
+                scratch.push_back(ast.add(parameter));
+                if (!atPunct(',')) {
+                    break;
+                }
+                advance();
+            }
+            return expectPunct(')', "')'"sv);
+        }
+
+        /**
+         * @brief Parses the body of a `continuation` function:
+         *        `{ [bindings], entry, [arguments] }`
+         */
+        int parseContinuationBody(NodeId& out) {
+            const Lexeme open = peek();
+            if (expectPunct('{', "'{'"sv) != 0) {
+                return -1;
+            }
+            const std::size_t mark = scratch.size();
+            NodeId part;
+            if (!atPunct('[')) {
+                return fail("'['"sv);
+            }
+            if (parseListLiteral(part, true) != 0) {
+                return -1;
+            }
+            scratch.push_back(part);
+            if (expectPunct(',', "','"sv) != 0 || parseExpression(1, part) != 0) {
+                return -1;
+            }
+            scratch.push_back(part);
+            if (expectPunct(',', "','"sv) != 0) {
+                return -1;
+            }
+            if (!atPunct('[')) {
+                return fail("'['"sv);
+            }
+            if (parseListLiteral(part, false) != 0) {
+                return -1;
+            }
+            scratch.push_back(part);
+            if (expectPunct('}', "'}'"sv) != 0) {
+                return -1;
+            }
+            out = finishList(named(NodeKind::Continuation, open), mark);
+            return 0;
+        }
+
+        /**
+         * @brief Parses what follows a function's name: its parameters and
+         *        either a body or the end of a prototype
+         */
+        int parseFunctionRest(Node function, NodeId returnType, NodeId& out) {
+            const std::size_t mark = scratch.size();
+            scratch.push_back(returnType);
+            scratch.push_back(NO_NODE);
+            if (parseParameters() != 0) {
+                return -1;
+            }
+            if (atPunct('{')) {
+                NodeId body;
+                const bool continuation = (function.flags & imperium_lang::FlagContinuation) != 0;
+                if ((continuation ? parseContinuationBody(body) : parseBlock(body)) != 0) {
+                    return -1;
+                }
+                scratch[mark + 1] = body;
+            } else if (atPunct(';')) {
+                advance();
+            } else if (!atPunct('}')) {
+                return fail("a function body or ';'"sv);
+            }
+            out = finishList(function, mark);
+            return 0;
+        }
+
+        /**
+         * @brief Parses a class: `class Name<T> { members }`
+         */
+        int parseClass(std::uint16_t flags, NodeId& out) {
+            advance();
+            Lexeme name;
+            if (expectIdentifier(name) != 0) {
+                return -1;
+            }
+            const std::size_t mark = scratch.size();
+            scratch.push_back(NO_NODE);
+            if (atOperator(OperatorKind::Less)) {
+                advance();
+                const std::size_t parametersMark = scratch.size();
+                while (true) {
+                    Lexeme parameter;
+                    if (expectIdentifier(parameter) != 0) {
+                        return -1;
+                    }
+                    scratch.push_back(ast.add(named(NodeKind::Identifier, parameter)));
+                    if (!atPunct(',')) {
+                        break;
+                    }
+                    advance();
+                }
+                if (expectClosingAngle() != 0) {
+                    return -1;
+                }
+                scratch[mark] = finishList(named(NodeKind::TypeParameters, name), parametersMark);
+            }
+            if (expectPunct('{', "'{'"sv) != 0) {
+                return -1;
+            }
+            while (!atPunct('}')) {
+                if (peek().kind == LexemeKind::End) {
+                    return fail("'}'"sv);
+                }
+                NodeId member;
+                if (parseDeclaration(member, text(name)) != 0) {
+                    return -1;
+                }
+                scratch.push_back(member);
+            }
+            advance();
+            out = finishList(named(NodeKind::ClassDecl, name, flags), mark);
+            return 0;
+        }
+
+        /**
+         * @brief Parses a declaration of a class, function or variable
+         * 
+         * @param[out] out The declaration
+         * @param[in] className Name of the enclosing class, if any, which
+         *            marks constructors
+         */
+        int parseDeclaration(NodeId& out, std::string_view className = {}) {
+            DepthGuard guard(depth);
+            if (checkDepth() != 0) {
+                return -1;
+            }
+            std::uint16_t flags = parseModifiers();
+            if (atKeyword(Keyword::Class)) {
+                return parseClass(flags, out);
+            }
+
+            // Constructors and methods without a return type go straight to
+            // their parameters
+            const Lexeme& first = peek();
+            if (!className.empty() && first.kind == LexemeKind::Identifier) {
+                if (text(first) == className && atPunct(':', 1) && peek(2).kind == LexemeKind::Identifier) {
+                    advance();
+                    advance();
+                    return parseFunctionRest(named(NodeKind::FunctionDecl, advance(),
+                        flags | imperium_lang::FlagConstructor | imperium_lang::FlagNamedConstructor), NO_NODE, out);
+                }
+                if (atPunct('(', 1)) {
+                    if (text(first) == className) {
+                        flags |= imperium_lang::FlagConstructor;
+                    }
+                    return parseFunctionRest(named(NodeKind::FunctionDecl, advance(), flags), NO_NODE, out);
+                }
+            }
+
+            NodeId type;
+            if (parseType(type) != 0) {
+                return -1;
+            }
+            if (peek().kind == LexemeKind::Identifier && text(peek()) == "continuation"sv
+                    && peek(1).kind == LexemeKind::Identifier) {
+                advance();
+                flags |= imperium_lang::FlagContinuation;
+            }
+            Lexeme name;
+            if (expectIdentifier(name) != 0) {
+                return -1;
+            }
+            if (atPunct('(')) {
+                return parseFunctionRest(named(NodeKind::FunctionDecl, name, flags), type, out);
+            }
+            Node variable = named(NodeKind::VariableDecl, name, flags);
+            variable.first = type;
+            if (atOperator(OperatorKind::Assign)) {
+                advance();
+                if (parseExpression(1, variable.second) != 0) {
+                    return -1;
+                }
+            }
+            if (expectPunct(';', "';'"sv) != 0) {
+                return -1;
+            }
+            out = ast.add(variable);
+            return 0;
+        }
+
+        /**
+         * @brief Parses a block: `{ statements }`
+         */
+        int parseBlock(NodeId& out) {
+            const Lexeme open = peek();
+            if (expectPunct('{', "'{'"sv) != 0) {
+                return -1;
+            }
+            const std::size_t mark = scratch.size();
+            while (!atPunct('}')) {
+                if (peek().kind == LexemeKind::End) {
+                    return fail("'}'"sv);
+                }
+                NodeId statement;
+                if (parseStatement(statement) != 0) {
+                    return -1;
+                }
+                if (statement != NO_NODE) {
+                    scratch.push_back(statement);
+                }
+            }
+            advance();
+            out = finishList(named(NodeKind::Block, open), mark);
+            return 0;
+        }
+
+        /**
+         * @brief Parses a parenthesized condition
+         */
+        int parseCondition(NodeId& out) {
+            if (expectPunct('(', "'('"sv) != 0 || parseExpression(1, out) != 0) {
+                return -1;
+            }
+            return expectPunct(')', "')'"sv);
+        }
+
+        /**
+         * @brief Parses one statement
+         * 
+         * @param[out] out The statement, or `NO_NODE` for an empty statement
+         */
+        int parseStatement(NodeId& out) {
+            DepthGuard guard(depth);
+            if (checkDepth() != 0) {
+                return -1;
+            }
+            out = NO_NODE;
+            const Lexeme first = peek();
+            if (atPunct('{')) {
+                return parseBlock(out);
+            }
+            if (atPunct(';')) {
+                advance();
+                return 0;
+            }
+            if (first.kind == LexemeKind::Keyword) {
+                switch (first.keyword) {
+                    case Keyword::If: {
+                        advance();
+                        const std::size_t mark = scratch.size();
+                        NodeId part;
+                        if (parseCondition(part) != 0) {
+                            return -1;
+                        }
+                        scratch.push_back(part);
+                        if (parseStatement(part) != 0) {
+                            return -1;
+                        }
+                        scratch.push_back(part);
+                        part = NO_NODE;
+                        if (atKeyword(Keyword::Else)) {
+                            advance();
+                            if (parseStatement(part) != 0) {
+                                return -1;
+                            }
+                        }
+                        scratch.push_back(part);
+                        out = finishList(named(NodeKind::If, first), mark);
+                        return 0;
+                    }
+                    case Keyword::While: {
+                        advance();
+                        Node loop = named(NodeKind::While, first);
+                        if (parseCondition(loop.first) != 0 || parseStatement(loop.second) != 0) {
+                            return -1;
+                        }
+                        out = ast.add(loop);
+                        return 0;
+                    }
+                    case Keyword::Do: {
+                        advance();
+                        Node loop = named(NodeKind::DoWhile, first);
+                        if (parseStatement(loop.first) != 0) {
+                            return -1;
+                        }
+                        if (!atKeyword(Keyword::While)) {
+                            return fail("'while'"sv);
+                        }
+                        advance();
+                        if (parseCondition(loop.second) != 0 || expectPunct(';', "';'"sv) != 0) {
+                            return -1;
+                        }
+                        out = ast.add(loop);
+                        return 0;
+                    }
+                    case Keyword::For:
+                        return parseFor(out);
+                    case Keyword::Return: {
+                        advance();
+                        Node result = named(NodeKind::Return, first);
+                        if (!atPunct(';') && parseExpression(1, result.first) != 0) {
+                            return -1;
+                        }
+                        if (expectPunct(';', "';'"sv) != 0) {
+                            return -1;
+                        }
+                        out = ast.add(result);
+                        return 0;
+                    }
+                    default:
+                        break;
+                }
+            }
+            if (startsDeclaration()) {
+                return parseDeclaration(out);
+            }
+            Node statement = named(NodeKind::ExpressionStatement, first);
+            if (parseExpression(1, statement.first) != 0 || expectPunct(';', "';'"sv) != 0) {
+                return -1;
+            }
+            out = ast.add(statement);
+            return 0;
+        }
+
+        /**
+         * @brief Parses `for (initializer; condition; step) body`
+         */
+        int parseFor(NodeId& out) {
+            const Lexeme first = advance();
+            if (expectPunct('(', "'('"sv) != 0) {
+                return -1;
+            }
+            const std::size_t mark = scratch.size();
+            NodeId part = NO_NODE;
+            if (atPunct(';')) {
+                advance();
+            } else if (startsDeclaration()) {
+                if (parseDeclaration(part) != 0) {
+                    return -1;
+                }
+            } else {
+                Node initializer = named(NodeKind::ExpressionStatement, peek());
+                if (parseExpression(1, initializer.first) != 0 || expectPunct(';', "';'"sv) != 0) {
+                    return -1;
+                }
+                part = ast.add(initializer);
+            }
+            scratch.push_back(part);
+            part = NO_NODE;
+            if (!atPunct(';') && parseExpression(1, part) != 0) {
+                return -1;
+            }
+            scratch.push_back(part);
+            if (expectPunct(';', "';'"sv) != 0) {
+                return -1;
+            }
+            part = NO_NODE;
+            if (!atPunct(')') && parseExpression(1, part) != 0) {
+                return -1;
+            }
+            scratch.push_back(part);
+            if (expectPunct(')', "')'"sv) != 0 || parseStatement(part) != 0) {
+                return -1;
+            }
+            scratch.push_back(part);
+            out = finishList(named(NodeKind::For, first), mark);
+            return 0;
+        }
+
+        /**
+         * @brief Parses `[elements]`
+         * 
+         * @param[out] out The list
+         * @param[in] commasOptional Whether elements may follow each other
+         *            without commas, as continuation bindings do
+         */
+        int parseListLiteral(NodeId& out, bool commasOptional) {
+            const Lexeme open = advance();
+            const std::size_t mark = scratch.size();
+            while (!atPunct(']')) {
+                NodeId element;
+                if (parseExpression(1, element) != 0) {
+                    return -1;
+                }
+                scratch.push_back(element);
+                if (atPunct(',')) {
+                    advance();
+                } else if (!commasOptional) {
+                    break;
+                }
+                if (peek().kind == LexemeKind::End) {
+                    break;
+                }
+            }
+            if (expectPunct(']', "']'"sv) != 0) {
+                return -1;
+            }
+            out = finishList(named(NodeKind::ListLiteral, open), mark);
+            return 0;
+        }
+
+        /**
+         * @brief Whether the `(` at the current lexeme opens lambda parameters
+         */
+        bool startsLambda() {
+            if (atPunct(')', 1)) {
+                return true;
+            }
+            const Lexeme& first = peek(1);
+            if (first.kind == LexemeKind::Keyword) {
+                return isTypeKeyword(first.keyword);
+            }
+            return first.kind == LexemeKind::Identifier
+                && (peek(2).kind == LexemeKind::Identifier || (atOperator(OperatorKind::Less, 2) && adjacent(1)));
+        }
+
+        /**
+         * @brief Parses `(parameters) => body`
+         */
+        int parseLambda(NodeId& out) {
+            const Lexeme open = peek();
+            const std::size_t mark = scratch.size();
+            scratch.push_back(NO_NODE);
+            if (parseParameters() != 0) {
+                return -1;
+            }
+            if (!atOperator(OperatorKind::Arrow)) {
+                return fail("'=>'"sv);
+            }
+            advance();
+            NodeId body;
+            if ((atPunct('{') ? parseBlock(body) : parseExpression(1, body)) != 0) {
+                return -1;
+            }
+            scratch[mark] = body;
+            out = finishList(named(NodeKind::Lambda, open), mark);
+            return 0;
+        }
+
+        /**
+         * @brief Parses an operand and any prefix operators before it
+         */
+        int parsePrefix(NodeId& out) {
+            const Lexeme first = peek();
+            switch (first.kind) {
+                case LexemeKind::Identifier:
+                    out = ast.add(named(NodeKind::Identifier, advance()));
+                    return 0;
+                case LexemeKind::Number:
+                    out = ast.add(named(NodeKind::NumberLiteral, advance()));
+                    return 0;
+                case LexemeKind::String:
+                    out = ast.add(named(NodeKind::StringLiteral, advance()));
+                    return 0;
+                case LexemeKind::Char:
+                    out = ast.add(named(NodeKind::CharLiteral, advance()));
+                    return 0;
+                case LexemeKind::Operator: {
+                    Node unary = named(NodeKind::Unary, first);
+                    if (first.op == OperatorKind::Subtract) {
+                        unary.op = Operator::Negate;
+                    } else if (first.op == OperatorKind::Not || first.op == OperatorKind::BitNot) {
+                        unary.op = astOperator(first.op);
+                    } else {
+                        return fail("an expression"sv);
+                    }
+                    advance();
+                    if (parseExpression(PREFIX_POWER, unary.first) != 0) {
+                        return -1;
+                    }
+                    out = ast.add(unary);
+                    return 0;
+                }
+                case LexemeKind::Punct:
+                    if (first.punct == '(') {
+                        if (startsLambda()) {
+                            return parseLambda(out);
+                        }
+                        advance();
+                        if (parseExpression(1, out) != 0) {
+                            return -1;
+                        }
+                        return expectPunct(')', "')'"sv);
+                    }
+                    if (first.punct == '[') {
+                        return parseListLiteral(out, false);
+                    }
+                    break;
+                default:
+                    break;
+            }
+            return fail("an expression"sv);
+        }
+
+        /**
+         * @brief Identifies the infix or postfix operator at the current
+         *        lexeme
+         * 
+         * @param[out] op The operator, or `None` for calls, indexing and
+         *             member access
+         * @return The operator's binding power, or 0 if none follows
+         */
+        std::uint8_t peekInfix(OperatorKind& op) {
+            const Lexeme& first = peek();
+            op = OperatorKind::None;
+            if (first.kind == LexemeKind::Operator) {
+                op = first.op;
+                return INFIX_POWER[static_cast<std::size_t>(op)];
+            }
+            if (first.kind != LexemeKind::Punct) {
+                return 0;
+            }
+            switch (first.punct) {
+                case '(':
+                case '[':
+                case '.':
+                    return POSTFIX_POWER;
+                default:
+                    return 0;
+            }
+        }
+
+        /**
+         * @brief Parses an expression whose operators bind at least as
+         *        tightly as `minPower`
+         */
+        int parseExpression(std::uint8_t minPower, NodeId& out) {
+            DepthGuard guard(depth);
+            if (checkDepth() != 0 || parsePrefix(out) != 0) {
+                return -1;
+            }
+            while (true) {
+                OperatorKind op;
+                const std::uint8_t power = peekInfix(op);
+                if (power == 0 || power < minPower) {
+                    return 0;
+                }
+                const Lexeme at = peek();
+                if (op == OperatorKind::None) {
+                    if ((at.punct == '(' ? parseCall(out) : at.punct == '[' ? parseIndex(out) : parseMember(out)) != 0) {
+                        return -1;
+                    }
+                    continue;
+                }
+                advance();
+
+                // Assignments group to the right, everything else to the left
+                const bool rightAssociative = power == INFIX_POWER[static_cast<std::size_t>(OperatorKind::Assign)];
+                Node binary = named(NodeKind::Binary, at);
+                binary.op = astOperator(op);
+                binary.first = out;
+                if (parseExpression(rightAssociative ? power : power + 1, binary.second) != 0) {
+                    return -1;
+                }
+                out = ast.add(binary);
+            }
+        }
+
+        int parseCall(NodeId& callee) {
+            const Lexeme open = advance();
+            const std::size_t mark = scratch.size();
+            scratch.push_back(callee);
+            while (!atPunct(')')) {
+                NodeId argument;
+                if (parseExpression(1, argument) != 0) {
+                    return -1;
+                }
+                scratch.push_back(argument);
+                if (!atPunct(',')) {
+                    break;
+                }
+                advance();
+            }
+            if (expectPunct(')', "')'"sv) != 0) {
+                return -1;
+            }
+            callee = finishList(named(NodeKind::Call, open), mark);
+            return 0;
+        }
+
+        int parseIndex(NodeId& base) {
+            Node index = named(NodeKind::Index, advance());
+            index.first = base;
+            if (parseExpression(1, index.second) != 0 || expectPunct(']', "']'"sv) != 0) {
+                return -1;
+            }
+            base = ast.add(index);
+            return 0;
+        }
+
+        int parseMember(NodeId& object) {
+            advance();
+            Lexeme name;
+            if (expectIdentifier(name) != 0) {
+                return -1;
+            }
+            Node member = named(NodeKind::Member, name);
+            member.first = object;
+            object = ast.add(member);
+            return 0;
+        }
+    public:
+        ParseState(std::string_view source, const imperium_lang::TokenBuffer& tokens, imperium_lang::Ast& ast,
+                std::vector<NodeId>& scratch) : source(source), tokens(tokens), ast(ast), scratch(scratch) {}
+
+        /**
+         * @brief Parses every declaration up to the end of the tokens
+         */
+        int parseModule(NodeId& out) {
+            const std::size_t mark = scratch.size();
+            while (peek().kind != LexemeKind::End) {
+                NodeId declaration;
+                if (parseDeclaration(declaration) != 0) {
+                    return -1;
+                }
+                scratch.push_back(declaration);
+            }
+            out = finishList(Node{NodeKind::Module}, mark);
+            return 0;
+        }
+    };
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Parses a whole source file
+     * 
+     * @param[in] source The source buffer the tokens were lexed from
+     * @param[in] tokens The tokens of `source`
+     * @param[out] ast The tree, reset and rooted at a `Module` node
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int Parser::parse(std::string_view source, const TokenBuffer& tokens, Ast& ast) {
+
+        ast.reset(source);
+        scratch.clear();
+        if (source.size() > TokenBuffer::MAX_SOURCE_SIZE) {
+            std::cerr << "Error: Source is too large to parse.\n";
+            return -1;
+        }
+        ParseState state(source, tokens, ast, scratch);
+        NodeId root;
+        if (state.parseModule(root) != 0) {
+            return -1;
+        }
+        ast.setRoot(root);
+
+        return 0;
+    }
+
+}
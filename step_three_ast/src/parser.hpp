@@ -0,0 +1,62 @@
+/**
+ * @file parser.hpp
+ * 
+ * @brief Include file for the single pass parser
+ */
+
+#ifndef PARSER_HPP
+#define PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "ast.hpp"
+#include "token_buffer.hpp"
+
+namespace imperium_lang {
+
+    // Bump whenever the tree produced for the same tokens changes, so
+    // cached trees from older parsers are not reused
+    constexpr std::uint32_t PARSER_VERSION = 2;
+
+    /**
+     * @brief Builds an `Ast` from the lexer's tokens
+     * 
+     * The parser makes one forward pass over the tokens with at most four
+     * significant tokens of lookahead and never backtracks. `Whitespace` and
+     * `Comment` tokens are stepped over in place, so tokens lexed with
+     * either `TriviaMode` parse the same. Expressions are parsed by
+     * precedence climbing over a binding power table.
+     * 
+     * Operators are `OperatorSequence` tokens of their own, lexed by
+     * maximal munch, so they need no whitespace around their operands. A
+     * `<` written directly after a type name opens its type arguments
+     * rather than comparing, and a `>>` closing two nested lists of type
+     * arguments is split in two.
+     * 
+     * A parser keeps its scratch storage between calls, so reusing one for
+     * many sources avoids allocating.
+     */
+    class Parser {
+    private:
+        std::vector<NodeId> scratch;
+    public:
+        static constexpr std::size_t MAX_DEPTH = 256;
+
+        /**
+         * @brief Parses a whole source file
+         * 
+         * @param[in] source The source buffer the tokens were lexed from
+         * @param[in] tokens The tokens of `source`
+         * @param[out] ast The tree, reset and rooted at a `Module` node
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         */
+        int parse(std::string_view source, const TokenBuffer& tokens, Ast& ast);
+    };
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file step_three.cpp
+ * 
+ * @brief Driver file to run a demo of the project reflecting the progress made in step three.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast.hpp"
+#include "content_cache.hpp"
+#include "parser.hpp"
+#include "tokenizer.hpp"
+#include "tokenizer_session.hpp"
+
+namespace {
+    constexpr std::string_view AST_CACHE_KIND = "ast";
+
+    // Trees depend on both the tokens and the parser
+    constexpr std::uint32_t AST_CACHE_VERSION = imperium_lang::TOKENIZER_VERSION << 16 | imperium_lang::PARSER_VERSION;
+}
+
+int main(int argc, char** argv) {
+
+    // Split options from source files
+    std::string cacheDirectory{};
+    std::uintmax_t cacheMegabytes = imperium_lang::ContentCache::DEFAULT_MAX_BYTES >> 20;
+    std::vector<std::string> paths{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--cache" && i + 1 < argc) {
+            cacheDirectory = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            cacheMegabytes = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            paths.emplace_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "Error: No source file provided.\n";
+        return 1;
+    }
+    std::optional<imperium_lang::ContentCache> cache{};
+    if (!cacheDirectory.empty()) {
+        cache.emplace(cacheDirectory, cacheMegabytes << 20);
+    }
+
+    // Extract tokens from every source file and parse them
+    imperium_lang::TokenizerSession session{};
+    session.setTriviaMode(imperium_lang::TriviaMode::Skip);
+    imperium_lang::Parser parser{};
+    imperium_lang::Ast ast{};
+    int status = 0;
+    for (const auto& path : paths) {
+        if (paths.size() > 1) {
+            std::cout << "File: " << path << "\n";
+        }
+        if (session.load(path) != 0) {
+            std::cerr << "Error: Tokenization failed for " << path << ".\n";
+            status = -1;
+            continue;
+        }
+
+        // A tree cached for the same content needs no lexing or parsing
+        imperium_lang::MappedFile entry{};
+        const bool cached = cache && cache->load(session.source(), AST_CACHE_KIND, AST_CACHE_VERSION, entry) == 0
+            && ast.readDump(entry.contents(), session.source()) == 0;
+        if (!cached) {
+            if (session.tokenize() != 0) {
+                std::cerr << "Error: Tokenization failed for " << path << ".\n";
+                status = -1;
+                continue;
+            }
+            if (parser.parse(session.source(), session.tokens(), ast) != 0) {
+                std::cerr << "Error: Parsing failed for " << path << ".\n";
+                status = -1;
+                continue;
+            }
+            std::ostringstream dump{};
+            if (cache && ast.writeDump(dump) == 0) {
+                cache->store(session.source(), AST_CACHE_KIND, AST_CACHE_VERSION, dump.view());
+            }
+        }
+
+        // Output the tree
+        std::cout << "Tree:\n";
+        imperium_lang::printTree(ast, std::cout);
+        std::cout << "Done.\n";
+    }
+
+    return status;
+}
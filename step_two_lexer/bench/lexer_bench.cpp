@@ -0,0 +1,421 @@
+/**
+ * @file lexer_bench.cpp
+ * 
+ * @brief Benchmark suite measuring lexer throughput, allocations and per-file
+ *        latency on deterministic synthetic corpora.
+ * 
+ * Usage: lexer_bench [--sizes 1K,1M,...] [--mixes name,...] [--file-size N]
+ *                    [--runs N] [--seed N] [--json path] [--emit dir]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "char_scan.hpp"
+#include "symbol_table.hpp"
+#include "token_buffer.hpp"
+#include "tokenizer.hpp"
+
+namespace {
+    std::atomic<std::size_t> allocationCount{0};
+}
+
+// Count every heap allocation so allocations per token can be reported
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+    /**
+     * @brief A family of generated sources stressing one part of the lexer
+     */
+    struct Mix {
+        const char* name;
+        void (*append)(std::string& text, std::mt19937_64& rng);
+    };
+
+    constexpr std::string_view WORDS[] = {
+        "value", "count", "nextValue", "index", "result", "widget_factory", "x", "i",
+        "MyClass", "fromArray", "lambda", "someNumber", "fibTail", "argv", "buffer", "node",
+    };
+    constexpr std::string_view KEYWORDS[] = {
+        "int", "return", "if", "else", "while", "class", "function", "string", "const", "static",
+    };
+
+    template <std::size_t N>
+    std::string_view pick(const std::string_view (&list)[N], std::mt19937_64& rng) {
+        return list[rng() % N];
+    }
+
+    void appendIdentifiers(std::string& text, std::mt19937_64& rng) {
+        text += pick(WORDS, rng);
+        text += rng() % 8 == 0 ? "\n" : " ";
+    }
+
+    void appendComments(std::string& text, std::mt19937_64& rng) {
+        if (rng() % 2 == 0) {
+            text += "// line comment about ";
+            text += pick(WORDS, rng);
+            text += " and ** stars / slashes\n";
+        } else {
+            text += "/* block comment\n * spanning ";
+            text += pick(WORDS, rng);
+            text += " lines ***/ ";
+        }
+    }
+
+    void appendNumbers(std::string& text, std::mt19937_64& rng) {
+        text += std::to_string(rng() % 1000000);
+        text += rng() % 4 == 0 ? ";\n" : ", ";
+    }
+
+    void appendWhitespace(std::string& text, std::mt19937_64& rng) {
+        text.append(1 + rng() % 32, " \t\n\r"[rng() % 4]);
+        text += pick(WORDS, rng);
+    }
+
+    void appendMixed(std::string& text, std::mt19937_64& rng) {
+        switch (rng() % 6) {
+            case 0: appendComments(text, rng); break;
+            case 1: appendNumbers(text, rng); break;
+            case 2: appendWhitespace(text, rng); break;
+            default:
+                text += "    ";
+                text += pick(KEYWORDS, rng);
+                text += " ";
+                text += pick(WORDS, rng);
+                text += " = ";
+                text += pick(WORDS, rng);
+                text += "(";
+                text += std::to_string(rng() % 100);
+                text += ", \"text\");\n";
+                break;
+        }
+    }
+
+    const std::vector<Mix> MIXES = {
+        {"identifiers", appendIdentifiers},
+        {"comments", appendComments},
+        {"numbers", appendNumbers},
+        {"whitespace", appendWhitespace},
+        {"mixed", appendMixed},
+    };
+
+    /**
+     * @brief Generates one file of a corpus
+     * 
+     * The file depends only on the mix, the seed and the file's index, so
+     * every run and every commit lexes the same bytes.
+     * 
+     * @param[in] mix The kind of source to generate
+     * @param[in] seed The corpus seed
+     * @param[in] index The file's index within the corpus
+     * @param[in] size The file's size in bytes
+     * @param[out] text The file's contents
+     */
+    void generateFile(const Mix& mix, std::uint64_t seed, std::size_t index, std::size_t size, std::string& text) {
+        std::mt19937_64 rng(seed ^ (0x9E3779B97F4A7C15ull * (index + 1)));
+        text.clear();
+        while (text.size() < size) {
+            mix.append(text, rng);
+        }
+
+        // Cut at a line end so no token or comment is left open
+        text.resize(size);
+        const std::size_t lastLine = text.rfind('\n');
+        text.resize(lastLine == std::string::npos ? 0 : lastLine + 1);
+        const std::size_t lastClose = text.rfind("*/");
+        if (text.find("/*", lastClose == std::string::npos ? 0 : lastClose) != std::string::npos) {
+            text += "*/\n";
+        }
+    }
+
+    /**
+     * @brief Parses a size such as `64K`, `1M` or `1G`
+     * 
+     * @return The size in bytes, or 0 if it cannot be parsed
+     */
+    std::size_t parseSize(std::string_view text) {
+        char* end = nullptr;
+        const std::string owned(text);
+        std::size_t size = std::strtoull(owned.c_str(), &end, 10);
+        switch (*end) {
+            case 'K': case 'k': size <<= 10; ++end; break;
+            case 'M': case 'm': size <<= 20; ++end; break;
+            case 'G': case 'g': size <<= 30; ++end; break;
+            default: break;
+        }
+        return *end == '\0' ? size : 0;
+    }
+
+    /**
+     * @brief Splits a comma separated list
+     */
+    std::vector<std::string> splitList(std::string_view text) {
+        std::vector<std::string> items;
+        while (!text.empty()) {
+            const std::size_t comma = text.find(',');
+            items.emplace_back(text.substr(0, comma));
+            text.remove_prefix(comma == std::string_view::npos ? text.size() : comma + 1);
+        }
+        return items;
+    }
+
+    /**
+     * @brief Measurements of one mix at one corpus size
+     */
+    struct BenchResult {
+        std::string mix;
+        std::size_t size = 0;
+        std::size_t files = 0;
+        std::size_t bytes = 0;
+        std::size_t tokens = 0;
+        std::size_t allocations = 0;
+        int runs = 0;
+        double seconds = 0.0;
+        double p50Micros = 0.0;
+        double p99Micros = 0.0;
+    };
+
+    double megabytesPerSecond(const BenchResult& result) {
+        return static_cast<double>(result.bytes) * result.runs / result.seconds / 1e6;
+    }
+
+    double tokensPerSecond(const BenchResult& result) {
+        return static_cast<double>(result.tokens) * result.runs / result.seconds;
+    }
+
+    double allocationsPerToken(const BenchResult& result) {
+        return static_cast<double>(result.allocations) / static_cast<double>(std::max<std::size_t>(result.tokens * result.runs, 1));
+    }
+
+    /**
+     * @brief Provides a percentile of sorted samples
+     */
+    double percentile(const std::vector<double>& sorted, double fraction) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const std::size_t rank = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    /**
+     * @brief Lexes every file of a corpus `runs` times
+     * 
+     * Files are generated one at a time, outside the timed region, so even
+     * a 1 GiB corpus only ever holds one file and its tokens in memory.
+     * 
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int runCorpus(const Mix& mix, std::size_t size, std::size_t fileSize, int runs, std::uint64_t seed, BenchResult& result) {
+        result = BenchResult{mix.name, size};
+        result.files = (size + fileSize - 1) / fileSize;
+        result.runs = runs;
+        std::string text;
+        imperium_lang::TokenBuffer tokens;
+        imperium_lang::SymbolTable symbols;
+        std::vector<double> latencies;
+        latencies.reserve(result.files * runs);
+        for (int run = 0; run < runs; ++run) {
+            for (std::size_t file = 0; file < result.files; ++file) {
+                generateFile(mix, seed, file, std::min(fileSize, size - file * fileSize), text);
+                symbols.clear();
+                const std::size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+                const auto start = std::chrono::steady_clock::now();
+                if (imperium_lang::Tokenizer::tokenize(text, tokens, &symbols) != 0) {
+                    std::cerr << "Error: Tokenization failed for " << mix.name << " file " << file << ".\n";
+                    return -1;
+                }
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                result.allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+                result.seconds += elapsed.count();
+                if (run == 0) {
+                    result.bytes += text.size();
+                    result.tokens += tokens.size();
+                }
+                latencies.push_back(elapsed.count() * 1e6);
+            }
+        }
+        std::sort(latencies.begin(), latencies.end());
+        result.p50Micros = percentile(latencies, 0.50);
+        result.p99Micros = percentile(latencies, 0.99);
+        return 0;
+    }
+
+    /**
+     * @brief Writes every corpus of the selected mixes and sizes as `.imp` files
+     * 
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Write Error
+     */
+    int emitCorpora(const std::vector<Mix>& mixes, const std::vector<std::size_t>& sizes, std::size_t fileSize,
+            std::uint64_t seed, const std::filesystem::path& directory) {
+        std::string text;
+        for (const auto& mix : mixes) {
+            for (const auto size : sizes) {
+                const auto corpus = directory / (std::string(mix.name) + "_" + std::to_string(size));
+                std::error_code error;
+                std::filesystem::create_directories(corpus, error);
+                for (std::size_t file = 0; file * fileSize < size; ++file) {
+                    generateFile(mix, seed, file, std::min(fileSize, size - file * fileSize), text);
+                    std::ofstream out(corpus / ("file_" + std::to_string(file) + ".imp"), std::ios::binary);
+                    if (!out.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+                        std::cerr << "Error: Failed to write corpus file.\n";
+                        return -2;
+                    }
+                }
+            }
+        }
+        return 0;
+    }
+
+    const char* kernelName(imperium_lang::ScanKernel kernel) {
+        switch (kernel) {
+            case imperium_lang::ScanKernel::AVX2: return "avx2";
+            case imperium_lang::ScanKernel::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+
+    const std::vector<std::string_view> OPTIONS = {"--sizes", "--mixes", "--file-size", "--runs", "--seed", "--json", "--emit"};
+
+    void printUsage() {
+        std::cerr << "Usage: lexer_bench [--sizes 1K,1M,...] [--mixes name,...] [--file-size N]\n"
+                  << "                   [--runs N] [--seed N] [--json path] [--emit dir]\n";
+    }
+}
+
+int main(int argc, char** argv) {
+
+    // Parse options
+    std::string sizeList = "1K,32K,1M,32M";
+    std::string mixList;
+    std::size_t fileSize = 64 << 10;
+    int runs = 3;
+    std::uint64_t seed = 42;
+    std::string jsonPath = "bench_results.json";
+    std::string emitDirectory;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string_view option = argv[i];
+        const bool known = std::find(OPTIONS.begin(), OPTIONS.end(), option) != OPTIONS.end();
+        if (!known || i + 1 == argc) {
+            std::cerr << "Error: " << (known ? "Missing value for option " : "Unknown option ") << option << ".\n";
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[i + 1];
+        if (option == "--sizes") {
+            sizeList = value;
+        } else if (option == "--mixes") {
+            mixList = value;
+        } else if (option == "--file-size") {
+            fileSize = parseSize(value);
+        } else if (option == "--runs") {
+            runs = std::atoi(value);
+        } else if (option == "--seed") {
+            seed = std::strtoull(value, nullptr, 10);
+        } else if (option == "--json") {
+            jsonPath = value;
+        } else if (option == "--emit") {
+            emitDirectory = value;
+        }
+    }
+    std::vector<std::size_t> sizes;
+    for (const auto& item : splitList(sizeList)) {
+        sizes.push_back(parseSize(item));
+        if (sizes.back() == 0) {
+            std::cerr << "Error: Invalid size " << item << ".\n";
+            return 1;
+        }
+    }
+    std::vector<Mix> mixes;
+    for (const auto& name : splitList(mixList)) {
+        const auto found = std::find_if(MIXES.begin(), MIXES.end(), [&](const Mix& mix) { return name == mix.name; });
+        if (found == MIXES.end()) {
+            std::cerr << "Error: Unknown mix " << name << ".\n";
+            return 1;
+        }
+        mixes.push_back(*found);
+    }
+    if (mixes.empty()) {
+        mixes = MIXES;
+    }
+    if (fileSize == 0 || runs <= 0) {
+        std::cerr << "Error: File size and runs must be positive.\n";
+        return 1;
+    }
+    if (!emitDirectory.empty()) {
+        return emitCorpora(mixes, sizes, fileSize, seed, emitDirectory) == 0 ? 0 : -1;
+    }
+
+    // Run every mix at every size
+    std::vector<BenchResult> results;
+    std::cout << std::left << std::setw(13) << "mix" << std::setw(12) << "bytes" << std::setw(10) << "MB/s"
+        << std::setw(14) << "Mtokens/s" << std::setw(12) << "allocs/tok" << std::setw(12) << "p50 us" << "p99 us\n";
+    for (const auto& mix : mixes) {
+        for (const auto size : sizes) {
+            BenchResult result;
+            if (runCorpus(mix, size, fileSize, runs, seed, result) != 0) {
+                return -1;
+            }
+            std::cout << std::setw(13) << result.mix << std::setw(12) << size << std::fixed << std::setprecision(1)
+                << std::setw(10) << megabytesPerSecond(result)
+                << std::setw(14) << tokensPerSecond(result) / 1e6 << std::setprecision(4)
+                << std::setw(12) << allocationsPerToken(result) << std::setprecision(1)
+                << std::setw(12) << result.p50Micros << result.p99Micros << "\n";
+            results.push_back(result);
+        }
+    }
+
+    // Write results for comparison between commits
+    std::ostringstream json;
+    json << std::setprecision(6) << "{\n  \"seed\": " << seed << ",\n  \"runs\": " << runs
+        << ",\n  \"file_size\": " << fileSize << ",\n  \"scan_kernel\": \"" << kernelName(imperium_lang::activeScanKernel())
+        << "\",\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        json << (i == 0 ? "\n" : ",\n") << "    {\"mix\": \"" << result.mix << "\", \"size\": " << result.size
+            << ", \"files\": " << result.files << ", \"bytes\": " << result.bytes << ", \"tokens\": " << result.tokens
+            << ", \"mb_per_s\": " << megabytesPerSecond(result)
+            << ", \"tokens_per_s\": " << tokensPerSecond(result)
+            << ", \"allocations_per_token\": " << allocationsPerToken(result)
+            << ", \"p50_file_us\": " << result.p50Micros << ", \"p99_file_us\": " << result.p99Micros << "}";
+    }
+    json << "\n  ]\n}\n";
+    std::ofstream out(jsonPath);
+    if (!(out << json.str())) {
+        std::cerr << "Error: Failed to write " << jsonPath << ".\n";
+        return -1;
+    }
+    std::cout << "Results written to " << jsonPath << "\n";
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file linear_bench.cpp
+ * 
+ * @brief Benchmark checking that lexing time grows linearly with input size
+ *        on inputs built to trigger super-linear behavior.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "tokenizer.hpp"
+
+namespace {
+
+    struct AdversarialInput {
+        const char* name;
+        std::function<std::string(std::size_t)> generate;
+    };
+
+    /**
+     * @brief Repeats `unit` until the result is at least `size` bytes
+     */
+    std::string repeat(const std::string& unit, std::size_t size) {
+        std::string text;
+        text.reserve(size + unit.size());
+        while (text.size() < size)
+            text += unit;
+        return text;
+    }
+
+    const std::vector<AdversarialInput> INPUTS = {
+        // Many short numbers, each followed by a delimiter far from the next whitespace
+        {"short-numbers", [](std::size_t size) { return repeat("1;", size); }},
+        // One number whose only terminator is at the very end
+        {"long-number", [](std::size_t size) { return repeat("1", size) + "a"; }},
+        // Numbers that turn into words on their last byte
+        {"number-words", [](std::size_t size) { return repeat("123456789a ", size); }},
+        {"slashes", [](std::size_t size) { return repeat("/ ", size); }},
+        // A block comment full of near-miss terminators
+        {"comment-stars", [](std::size_t size) { return "/*" + repeat("**", size) + "*/"; }},
+        {"delimiters", [](std::size_t size) { return repeat("()", size); }},
+    };
+
+    /**
+     * @brief Times the fastest of several tokenizations of `source`
+     * 
+     * @return Seconds taken, or a negative value if tokenizing failed
+     */
+    double timeTokenize(const std::string& source, std::vector<imperium_lang::TokenView>& tokens) {
+        double best = -1.0;
+        for (int run = 0; run < 3; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            if (imperium_lang::Tokenizer::tokenize(source, tokens) != 0)
+                return -1.0;
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = best < 0.0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+
+    // Largest input size in MiB, doubling up from 1 MiB
+    const std::size_t maxMiB = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32;
+    // Allowed growth in ns/byte from smallest to largest size. Cache effects
+    // stay well under this, while quadratic behavior grows with the size ratio.
+    constexpr double MAX_SLOWDOWN = 4.0;
+
+    bool linear = true;
+    std::vector<imperium_lang::TokenView> tokens{};
+    std::cout << std::left << std::setw(16) << "input" << std::setw(10) << "MiB" << std::setw(12) << "ns/byte" << "tokens\n";
+    for (const auto& input : INPUTS) {
+        double firstNsPerByte = 0.0;
+        double lastNsPerByte = 0.0;
+        for (std::size_t mib = 1; mib <= maxMiB; mib *= 2) {
+            const std::string source = input.generate(mib << 20);
+            const double seconds = timeTokenize(source, tokens);
+            if (seconds < 0.0) {
+                std::cerr << "Error: Tokenization failed for " << input.name << ".\n";
+                return -1;
+            }
+            lastNsPerByte = seconds * 1e9 / static_cast<double>(source.size());
+            if (mib == 1)
+                firstNsPerByte = lastNsPerByte;
+            std::cout << std::setw(16) << input.name << std::setw(10) << mib << std::setw(12) << std::setprecision(3) << lastNsPerByte << tokens.size() << "\n";
+        }
+        if (lastNsPerByte > firstNsPerByte * MAX_SLOWDOWN) {
+            std::cout << input.name << ": not linear (" << firstNsPerByte << " -> " << lastNsPerByte << " ns/byte)\n";
+            linear = false;
+        }
+    }
+    std::cout << (linear ? "All inputs lexed in linear time.\n" : "Super-linear lexing detected.\n");
+
+    return linear ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file batch_tokenizer.cpp
+ * 
+ * @brief Implementation file for tokenizing many source files in parallel
+ */
+
+#include "batch_tokenizer.hpp"
+#include "parallel_lexer.hpp"
+#include "thread_pool.hpp"
+#include "token_dump.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    /**
+     * @brief Provides the kind of cache entry for tokens lexed in a mode
+     * 
+     * @param[in] trivia The trivia mode the tokens were lexed in
+     */
+    constexpr std::string_view tokenCacheKind(imperium_lang::TriviaMode trivia) {
+        return trivia == imperium_lang::TriviaMode::Skip ? "tokens-no-trivia" : "tokens";
+    }
+
+    /**
+     * @brief Reads a file's tokens back from its cache entry
+     * 
+     * An entry is a token dump, whose payloads hold the keywords and
+     * operators as they were lexed and the ids of symbols and numbers.
+     * Symbols were interned in stream order, so only the first use of each
+     * one is interned again and the ids come out as they were. Numbers are
+     * decoded again in stream order the same way.
+     * 
+     * @param[in] entry The cache entry
+     * @param[in, out] result The file, with its source loaded
+     * @return Whether the entry held tokens for the source
+     */
+    bool readCachedTokens(std::string_view entry, imperium_lang::FileTokens& result) {
+        imperium_lang::TokenDump dump;
+        std::size_t bytesUsed;
+        const std::string_view source = result.source.view();
+        if (imperium_lang::readTokenDump(entry, dump, bytesUsed) != 0 || dump.sourceSize != source.size() || entry.size() != bytesUsed) {
+            return false;
+        }
+        result.tokens.clear();
+        result.tokens.reserve(dump.kinds.size());
+        for (std::size_t i = 0; i < dump.kinds.size(); ++i) {
+            imperium_lang::TokenView token{dump.kinds[i], dump.offsets[i], dump.lengths[i]};
+            bool valid = token.offset + token.length <= source.size();
+            if (valid && token.type == imperium_lang::TokenType::ReservedWord) {
+                token.keyword = static_cast<imperium_lang::Keyword>(dump.payloads[i]);
+            } else if (valid && token.type == imperium_lang::TokenType::OperatorSequence) {
+                token.op = static_cast<imperium_lang::OperatorKind>(dump.payloads[i]);
+            } else if (valid && token.type == imperium_lang::TokenType::CharSequence) {
+                token.symbol = dump.payloads[i] < result.symbols.size() ? dump.payloads[i] : result.symbols.intern(token.text(source));
+                valid = token.symbol == dump.payloads[i];
+            } else if (valid && token.type == imperium_lang::TokenType::Number) {
+                token.number = result.numbers.add(token.text(source));
+                valid = token.number == dump.payloads[i];
+            }
+            if (!valid) {
+                result.tokens.clear();
+                result.symbols.clear();
+                result.numbers.clear();
+                return false;
+            }
+            result.tokens.push_back(token);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Adds a file's tokens to the cache
+     * 
+     * @param[in] result The tokenized file
+     * @param[in] trivia The trivia mode the tokens were lexed in
+     * @param[in, out] cache The cache to add to
+     */
+    void storeCachedTokens(const imperium_lang::FileTokens& result, imperium_lang::TriviaMode trivia, imperium_lang::ContentCache& cache) {
+        std::ostringstream entry;
+        if (imperium_lang::writeTokenDump(result.source.view().size(), result.tokens, entry) != 0) {
+            return;
+        }
+        cache.store(result.source.view(), tokenCacheKind(trivia), imperium_lang::TOKENIZER_VERSION, entry.view());
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Expands directories into the `.imp` files below them
+     * 
+     * Files are kept as given. Each directory is walked recursively and its
+     * `.imp` files are added in sorted order.
+     * 
+     * @param[in] inputs Files and directories
+     * @param[out] paths The source files found
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int collectSourceFiles(const std::vector<std::string>& inputs, std::vector<std::string>& paths) {
+
+        paths.clear();
+        for (const auto& input : inputs) {
+            std::error_code error;
+            if (!std::filesystem::is_directory(input, error)) {
+                paths.push_back(input);
+                continue;
+            }
+            std::vector<std::string> found;
+            for (std::filesystem::recursive_directory_iterator it(input, error), end; !error && it != end; it.increment(error)) {
+                if (it->is_regular_file(error) && it->path().extension() == ".imp") {
+                    found.push_back(it->path().string());
+                }
+            }
+            if (error) {
+                std::cerr << "Error: Failed to read directory " << input << ".\n";
+                return -2;
+            }
+            std::sort(found.begin(), found.end());
+            paths.insert(paths.end(), found.begin(), found.end());
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Tokenizes many source files on a work stealing thread pool
+     * 
+     * @param[in] paths The source files to tokenize
+     * @param[out] results One entry per path, in the same order as `paths`
+     * @param[out] stats Aggregate numbers for the batch
+     * @param[in] threadCount Number of worker threads. 0 uses one per core.
+     * @param[in, out] cache Cache of earlier results. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @return Status code
+     * @retval 0 Every file was tokenized
+     * @retval -1 At least one file failed; see each result's `status`
+     */
+    int tokenizeFiles(const std::vector<std::string>& paths, std::vector<FileTokens>& results, BatchStats& stats,
+        std::size_t threadCount, ContentCache* cache, TriviaMode trivia) {
+
+        const auto start = std::chrono::steady_clock::now();
+        results.clear();
+        results.resize(paths.size());
+        WorkStealingPool pool(threadCount);
+
+        // Every worker keeps one reader for sources that cannot be mapped.
+        // Without a cache to look them up in first, such sources are left
+        // open, to be lexed while the rest is read.
+        std::vector<StreamReader> readers(pool.size());
+        const auto load = [&](std::size_t worker, FileTokens& result) {
+            const int openStatus = result.source.open(result.path, readers[worker]);
+            return openStatus == 0 && cache != nullptr ? result.source.readRest() : openStatus;
+        };
+
+        // Files found in the cache skip lexing altogether
+        std::vector<char> cached(paths.size(), false);
+        const auto loadCached = [&](std::size_t index) {
+            MappedFile entry;
+            FileTokens& result = results[index];
+            cached[index] = cache != nullptr
+                && cache->load(result.source.view(), tokenCacheKind(trivia), TOKENIZER_VERSION, entry) == 0
+                && readCachedTokens(entry.contents(), result);
+            return cached[index] != 0;
+        };
+        const auto storeCached = [&](std::size_t index) {
+            if (cache != nullptr && results[index].status == 0) {
+                storeCachedTokens(results[index], trivia, *cache);
+            }
+        };
+
+        if (paths.size() == 1) {
+            // A single file gets the whole pool by splitting it into chunks
+            FileTokens& result = results.front();
+            result.path = paths.front();
+            result.status = load(0, result);
+            if (result.status == 0 && !result.source.complete()) {
+                result.status = Tokenizer::tokenize(result.source, result.tokens, &result.symbols, trivia, &result.numbers);
+            } else if (result.status == 0 && !loadCached(0)) {
+                result.status = tokenizeParallel(result.source.view(), result.tokens, &result.symbols, pool, 0, trivia, &result.numbers);
+                storeCached(0);
+            }
+        } else {
+            pool.parallelFor(paths.size(), [&](std::size_t worker, std::size_t index) {
+                FileTokens& result = results[index];
+                result.path = paths[index];
+                result.status = load(worker, result);
+                if (result.status == 0 && !result.source.complete()) {
+                    result.status = Tokenizer::tokenize(result.source, result.tokens, &result.symbols, trivia, &result.numbers);
+                } else if (result.status == 0 && !loadCached(index)) {
+                    result.status = Tokenizer::tokenize(result.source.view(), result.tokens, &result.symbols, trivia, &result.numbers);
+                    storeCached(index);
+                }
+            });
+        }
+
+        stats = BatchStats{};
+        stats.threads = pool.size();
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const FileTokens& result = results[i];
+            ++stats.files;
+            stats.cacheHits += cached[i];
+            stats.bytes += result.source.view().size();
+            stats.tokens += result.tokens.size();
+            if (result.status != 0) {
+                ++stats.failedFiles;
+            }
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return stats.failedFiles == 0 ? 0 : -1;
+    }
+
+}
@@ -0,0 +1,94 @@
+/**
+ * @file batch_tokenizer.hpp
+ * 
+ * @brief Include file for tokenizing many source files in parallel
+ */
+
+#ifndef BATCH_TOKENIZER_HPP
+#define BATCH_TOKENIZER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "content_cache.hpp"
+#include "number_table.hpp"
+#include "source_text.hpp"
+#include "symbol_table.hpp"
+#include "tokenizer.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief Tokens of one file from a batch
+     * 
+     * The tokens borrow their text from `source` and their symbol and
+     * number ids are local to `symbols` and `numbers`, so results do not
+     * depend on which worker lexed the file.
+     */
+    struct FileTokens {
+        std::string path;
+        int status = 0;
+        SourceText source;
+        std::vector<TokenView> tokens;
+        SymbolTable symbols;
+        NumberTable numbers;
+    };
+
+    /**
+     * @brief Aggregate numbers for a batch
+     */
+    struct BatchStats {
+        std::size_t files = 0;
+        std::size_t failedFiles = 0;
+        std::size_t bytes = 0;
+        std::size_t tokens = 0;
+        std::size_t cacheHits = 0;
+        std::size_t threads = 0;
+        double seconds = 0.0;
+
+        double megabytesPerSecond() const { return seconds > 0.0 ? bytes / seconds / 1e6 : 0.0; }
+        double tokensPerSecond() const { return seconds > 0.0 ? tokens / seconds : 0.0; }
+    };
+
+    /**
+     * @brief Expands directories into the `.imp` files below them
+     * 
+     * Files are kept as given. Each directory is walked recursively and its
+     * `.imp` files are added in sorted order.
+     * 
+     * @param[in] inputs Files and directories
+     * @param[out] paths The source files found
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int collectSourceFiles(const std::vector<std::string>& inputs, std::vector<std::string>& paths);
+
+    /**
+     * @brief Tokenizes many source files on a work stealing thread pool
+     * 
+     * Files are spread over the workers. A batch of a single file is split
+     * into chunks with `tokenizeParallel` instead. Files that cannot be
+     * mapped, such as pipes, are lexed as they are read unless there is a
+     * cache, which needs their whole content first.
+     * 
+     * With a cache, a file whose content was tokenized before is read back
+     * from its token dump instead of being lexed, and newly lexed files are
+     * added to the cache.
+     * 
+     * @param[in] paths The source files to tokenize
+     * @param[out] results One entry per path, in the same order as `paths`
+     * @param[out] stats Aggregate numbers for the batch
+     * @param[in] threadCount Number of worker threads. 0 uses one per core.
+     * @param[in, out] cache Cache of earlier results. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @return Status code
+     * @retval 0 Every file was tokenized
+     * @retval -1 At least one file failed; see each result's `status`
+     */
+    int tokenizeFiles(const std::vector<std::string>& paths, std::vector<FileTokens>& results, BatchStats& stats,
+        std::size_t threadCount = 0, ContentCache* cache = nullptr, TriviaMode trivia = TriviaMode::Keep);
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file char_class.hpp
+ * 
+ * @brief Include file for the compile time character class table
+ */
+
+#ifndef CHAR_CLASS_HPP
+#define CHAR_CLASS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "language_spec.hpp"
+
+// Allow string_view literals
+using namespace std::literals::string_view_literals;
+
+namespace imperium_lang {
+
+    constexpr auto WHITESPACE = " \n\t\r"sv;
+    constexpr auto DIGIT = "1234567890"sv;
+    constexpr auto HEX_DIGIT = "1234567890abcdefABCDEF"sv;
+    constexpr auto BINARY_DIGIT = "01"sv;
+    constexpr auto NON_WHITESPACE_CHARACTER = 
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890!@#$%^&*_-+=|\\/?~`"sv;
+
+    // The non-whitespace characters that are not operator or delimiter
+    // bytes, which break words apart
+    constexpr auto WORD_CHARACTER_BYTES = [] {
+        std::array<char, NON_WHITESPACE_CHARACTER.size()> bytes{};
+        std::size_t count = 0;
+        for (char c : NON_WHITESPACE_CHARACTER)
+            if (PUNCTUATION_CHARACTER.find(c) == std::string_view::npos)
+                bytes[count++] = c;
+        return std::pair{bytes, count};
+    }();
+    constexpr std::string_view WORD_CHARACTER{WORD_CHARACTER_BYTES.first.data(), WORD_CHARACTER_BYTES.second};
+
+    // Every byte that can appear in a multi-byte UTF-8 sequence. These are
+    // word characters; whether the sequences are well formed is checked
+    // separately by `findInvalidUtf8`.
+    constexpr auto UTF8_SEQUENCE_BYTE_ARRAY = [] {
+        std::array<char, 128> bytes{};
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<char>(0x80 + i);
+        return bytes;
+    }();
+    constexpr std::string_view UTF8_SEQUENCE_BYTE{UTF8_SEQUENCE_BYTE_ARRAY.data(), UTF8_SEQUENCE_BYTE_ARRAY.size()};
+
+    /**
+     * @brief Character classes a byte can belong to, as bit flags
+     */
+    enum CharClass : std::uint8_t {
+        ClassWhitespace = 1 << 0,
+        ClassDelimiter = 1 << 1,
+        ClassDigit = 1 << 2,
+        ClassWord = 1 << 3,
+        ClassPunctuation = 1 << 4,
+    };
+
+    namespace detail {
+        /**
+         * @brief Builds the byte to character class table at compile time
+         */
+        constexpr std::array<std::uint8_t, 256> buildCharClassTable() {
+            std::array<std::uint8_t, 256> table{};
+            const auto mark = [&table](std::string_view characters, CharClass charClass) {
+                for (char c : characters)
+                    table[static_cast<unsigned char>(c)] |= charClass;
+            };
+            mark(WHITESPACE, ClassWhitespace);
+            mark(DELIMITER, ClassDelimiter);
+            mark(PUNCTUATION_CHARACTER, ClassPunctuation);
+            mark(DIGIT, ClassDigit);
+            mark(WORD_CHARACTER, ClassWord);
+            mark(UTF8_SEQUENCE_BYTE, ClassWord);
+            return table;
+        }
+    }
+
+    constexpr std::array<std::uint8_t, 256> CHAR_CLASS_TABLE = detail::buildCharClassTable();
+
+    /**
+     * @brief Checks if a byte belongs to any of the given character classes
+     * 
+     * @param[in] c The byte to check
+     * @param[in] charClass Bitwise or of the `CharClass` flags to test
+     */
+    constexpr bool isCharClass(char c, std::uint8_t charClass) {
+        return (CHAR_CLASS_TABLE[static_cast<unsigned char>(c)] & charClass) != 0;
+    }
+
+}
+
+#endif
@@ -0,0 +1,376 @@
+/**
+ * @file char_scan.cpp
+ * 
+ * @brief Implementation file for character class run scanning kernels
+ */
+
+#include "char_scan.hpp"
+#include "char_class.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define IMPERIUM_X86_KERNELS 1
+#endif
+
+namespace {
+
+    using imperium_lang::ScanKernel;
+
+    // The ASCII word characters that are neither letters nor digits
+    constexpr auto WORD_SYMBOL_BYTES = [] {
+        std::array<char, imperium_lang::WORD_CHARACTER.size()> bytes{};
+        std::size_t count = 0;
+        for (char c : imperium_lang::WORD_CHARACTER)
+            if (static_cast<unsigned>((c | 0x20) - 'a') >= 26u && !imperium_lang::isCharClass(c, imperium_lang::ClassDigit))
+                bytes[count++] = c;
+        return std::pair{bytes, count};
+    }();
+    constexpr std::string_view WORD_SYMBOL{WORD_SYMBOL_BYTES.first.data(), WORD_SYMBOL_BYTES.second};
+
+    /**
+     * @brief Checks that `ClassWord` is exactly the letters, digits and
+     *        `WORD_SYMBOL` bytes plus every non-ASCII byte, which the vector
+     *        kernels rely on
+     */
+    constexpr bool wordIsAlphanumericOrSymbol() {
+        for (int c = 0; c < 256; ++c) {
+            const bool alphanumeric = static_cast<unsigned>((c | 0x20) - 'a') < 26u || (c >= '0' && c <= '9');
+            const bool symbol = c < 0x80 && c != 0 && WORD_SYMBOL.find(static_cast<char>(c)) != std::string_view::npos;
+            const bool word = (imperium_lang::CHAR_CLASS_TABLE[c] & imperium_lang::ClassWord) != 0;
+            if (word != (alphanumeric || symbol || c >= 0x80))
+                return false;
+        }
+        return true;
+    }
+    static_assert(wordIsAlphanumericOrSymbol(), "Vector word kernels assume words are letters, digits and WORD_SYMBOL bytes");
+
+    /**
+     * @brief Measures the UTF-8 sequence starting at `text[i]`
+     * 
+     * Overlong forms, surrogates and code points past U+10FFFF are not
+     * well formed.
+     * 
+     * @param[in] text The text holding the sequence
+     * @param[in] i Offset of the sequence's first byte, below `text.size()`
+     * @return Length of the sequence, or 0 if it is not well formed
+     */
+    std::size_t utf8SequenceLength(std::string_view text, std::size_t i) {
+        const auto byte = [&](std::size_t k) { return static_cast<unsigned char>(text[i + k]); };
+        const unsigned char lead = byte(0);
+        if (lead < 0x80)
+            return 1;
+
+        // The second byte's range rules out overlong forms and surrogates
+        std::size_t length;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            low = lead == 0xE0 ? 0xA0 : low;
+            high = lead == 0xED ? 0x9F : high;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            low = lead == 0xF0 ? 0x90 : low;
+            high = lead == 0xF4 ? 0x8F : high;
+        } else {
+            return 0;
+        }
+        if (text.size() - i < length || byte(1) < low || byte(1) > high)
+            return 0;
+        for (std::size_t k = 2; k < length; ++k)
+            if ((byte(k) & 0xC0) != 0x80)
+                return 0;
+        return length;
+    }
+
+    /**
+     * @brief Finds the first malformed UTF-8 sequence from an offset on,
+     *        skipping ASCII eight bytes at a time
+     * 
+     * @param[in] text The text to check
+     * @param[in] i Offset to start at, on a sequence boundary
+     * @return Offset of the malformed sequence, or `npos` if there is none
+     */
+    std::size_t scalarInvalidUtf8From(std::string_view text, std::size_t i) {
+        while (i < text.size()) {
+            std::uint64_t word;
+            if (i + 8 <= text.size() && (std::memcpy(&word, text.data() + i, 8), (word & 0x8080808080808080u) == 0)) {
+                i += 8;
+                continue;
+            }
+            const std::size_t length = utf8SequenceLength(text, i);
+            if (length == 0)
+                return i;
+            i += length;
+        }
+        return std::string_view::npos;
+    }
+
+    std::size_t scalarInvalidUtf8(std::string_view text) { return scalarInvalidUtf8From(text, 0); }
+
+    /**
+     * @brief Checks the sequences starting before `end`, for a block that is
+     *        not pure ASCII
+     * 
+     * @param[in] text The text to check
+     * @param[in, out] i Offset to start at, on a sequence boundary. Left on
+     *                 the first sequence boundary at or after `end`.
+     * @param[in] end End of the block
+     * @return Whether every sequence was well formed
+     */
+    bool validateMixedBlock(std::string_view text, std::size_t& i, std::size_t end) {
+        while (i < end) {
+            const std::size_t length = utf8SequenceLength(text, i);
+            if (length == 0)
+                return false;
+            i += length;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Measures a run of one character class a byte at a time
+     * 
+     * @param[in] text The text to scan
+     * @param[in] charClass The `CharClass` flags the run consists of
+     * @return Length of the run
+     */
+    std::size_t scalarRun(std::string_view text, std::uint8_t charClass) {
+        std::size_t i = 0;
+        while (i < text.size() && imperium_lang::isCharClass(text[i], charClass))
+            ++i;
+        return i;
+    }
+
+    std::size_t scalarWhitespace(std::string_view text) { return scalarRun(text, imperium_lang::ClassWhitespace); }
+    std::size_t scalarDigits(std::string_view text) { return scalarRun(text, imperium_lang::ClassDigit); }
+    std::size_t scalarWord(std::string_view text) { return scalarRun(text, imperium_lang::ClassWord); }
+
+    /**
+     * @brief Appends the offset of every newline a byte at a time
+     * 
+     * @param[in] text The text to scan
+     * @param[in] base Offset of `text` within the whole source
+     * @param[out] offsets Offsets of the newlines, in order
+     */
+    void scalarNewlinesFrom(std::string_view text, std::size_t base, std::vector<std::size_t>& offsets) {
+        for (std::size_t i = 0; i < text.size(); ++i)
+            if (text[i] == '\n')
+                offsets.push_back(base + i);
+    }
+
+    void scalarNewlines(std::string_view text, std::vector<std::size_t>& offsets) { scalarNewlinesFrom(text, 0, offsets); }
+
+#ifdef IMPERIUM_X86_KERNELS
+
+    /* SSE2: 16 bytes per step. Each predicate returns 0xFF in lanes whose byte is in the class. */
+
+    inline __m128i sse2Whitespace(__m128i v) {
+        __m128i in = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+        in = _mm_or_si128(in, _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+        in = _mm_or_si128(in, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+        return _mm_or_si128(in, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+    }
+
+    inline __m128i sse2Digit(__m128i v) {
+        const __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+        return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)), offset);
+    }
+
+    inline __m128i sse2Word(__m128i v) {
+
+        // Setting bit 5 folds upper case letters onto lower case ones
+        const __m128i letter = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i in = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(25)), letter);
+        in = _mm_or_si128(in, sse2Digit(v));
+        in = _mm_or_si128(in, _mm_cmplt_epi8(v, _mm_setzero_si128()));
+        for (char c : WORD_SYMBOL)
+            in = _mm_or_si128(in, _mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+        return in;
+    }
+
+    template <__m128i (*InClass)(__m128i), std::uint8_t CharClass>
+    std::size_t sse2Run(std::string_view text) {
+        const char* data = text.data();
+        std::size_t i = 0;
+        for (; i + 16 <= text.size(); i += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const unsigned outside = ~static_cast<unsigned>(_mm_movemask_epi8(InClass(block))) & 0xFFFFu;
+            if (outside != 0)
+                return i + static_cast<std::size_t>(__builtin_ctz(outside));
+        }
+        return i + scalarRun(text.substr(i), CharClass);
+    }
+
+    std::size_t sse2Whitespaces(std::string_view text) { return sse2Run<sse2Whitespace, imperium_lang::ClassWhitespace>(text); }
+    std::size_t sse2Digits(std::string_view text) { return sse2Run<sse2Digit, imperium_lang::ClassDigit>(text); }
+    std::size_t sse2Words(std::string_view text) { return sse2Run<sse2Word, imperium_lang::ClassWord>(text); }
+
+    void sse2Newlines(std::string_view text, std::vector<std::size_t>& offsets) {
+        const char* data = text.data();
+        std::size_t i = 0;
+        for (; i + 16 <= text.size(); i += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))));
+            for (; mask != 0; mask &= mask - 1)
+                offsets.push_back(i + static_cast<std::size_t>(__builtin_ctz(mask)));
+        }
+        scalarNewlinesFrom(text.substr(i), i, offsets);
+    }
+
+    std::size_t sse2InvalidUtf8(std::string_view text) {
+        const char* data = text.data();
+        std::size_t i = 0;
+        while (i + 16 <= text.size()) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            if (_mm_movemask_epi8(block) == 0) {
+                i += 16;
+            } else if (!validateMixedBlock(text, i, i + 16)) {
+                return i;
+            }
+        }
+        return scalarInvalidUtf8From(text, i);
+    }
+
+    /* AVX2: the same predicates over 32 bytes per step. */
+
+    __attribute__((target("avx2"))) inline __m256i avx2Whitespace(__m256i v) {
+        __m256i in = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+        in = _mm256_or_si256(in, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+        in = _mm256_or_si256(in, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+        return _mm256_or_si256(in, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+    }
+
+    __attribute__((target("avx2"))) inline __m256i avx2Digit(__m256i v) {
+        const __m256i offset = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(9)), offset);
+    }
+
+    __attribute__((target("avx2"))) inline __m256i avx2Word(__m256i v) {
+        const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i in = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(25)), letter);
+        in = _mm256_or_si256(in, avx2Digit(v));
+        in = _mm256_or_si256(in, _mm256_cmpgt_epi8(_mm256_setzero_si256(), v));
+        for (char c : WORD_SYMBOL)
+            in = _mm256_or_si256(in, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+        return in;
+    }
+
+    template <__m256i (*InClass)(__m256i), std::uint8_t CharClass>
+    __attribute__((target("avx2"))) std::size_t avx2Run(std::string_view text) {
+        const char* data = text.data();
+        std::size_t i = 0;
+        for (; i + 32 <= text.size(); i += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            const unsigned outside = ~static_cast<unsigned>(_mm256_movemask_epi8(InClass(block)));
+            if (outside != 0)
+                return i + static_cast<std::size_t>(__builtin_ctz(outside));
+        }
+        return i + scalarRun(text.substr(i), CharClass);
+    }
+
+    __attribute__((target("avx2"))) std::size_t avx2Whitespaces(std::string_view text) { return avx2Run<avx2Whitespace, imperium_lang::ClassWhitespace>(text); }
+    __attribute__((target("avx2"))) std::size_t avx2Digits(std::string_view text) { return avx2Run<avx2Digit, imperium_lang::ClassDigit>(text); }
+    __attribute__((target("avx2"))) std::size_t avx2Words(std::string_view text) { return avx2Run<avx2Word, imperium_lang::ClassWord>(text); }
+
+    __attribute__((target("avx2"))) void avx2Newlines(std::string_view text, std::vector<std::size_t>& offsets) {
+        const char* data = text.data();
+        std::size_t i = 0;
+        for (; i + 32 <= text.size(); i += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))));
+            for (; mask != 0; mask &= mask - 1)
+                offsets.push_back(i + static_cast<std::size_t>(__builtin_ctz(mask)));
+        }
+        scalarNewlinesFrom(text.substr(i), i, offsets);
+    }
+
+    __attribute__((target("avx2"))) std::size_t avx2InvalidUtf8(std::string_view text) {
+        const char* data = text.data();
+        std::size_t i = 0;
+        while (i + 32 <= text.size()) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            if (_mm256_movemask_epi8(block) == 0) {
+                i += 32;
+            } else if (!validateMixedBlock(text, i, i + 32)) {
+                return i;
+            }
+        }
+        return scalarInvalidUtf8From(text, i);
+    }
+
+#endif
+
+    /**
+     * @brief One implementation of every scanning kernel
+     */
+    struct ScanKernels {
+        ScanKernel kernel;
+        std::size_t (*whitespace)(std::string_view);
+        std::size_t (*digits)(std::string_view);
+        std::size_t (*word)(std::string_view);
+        void (*newlines)(std::string_view, std::vector<std::size_t>&);
+        std::size_t (*invalidUtf8)(std::string_view);
+    };
+
+    /**
+     * @brief Picks the kernels for an instruction set, downgrading to what
+     *        the CPU supports
+     * 
+     * The first pick happens during static initialization, which may run
+     * before the constructor that fills in the CPU features, so they are
+     * read explicitly first.
+     * 
+     * @param[in] kernel The preferred instruction set
+     */
+    ScanKernels kernelsFor(ScanKernel kernel) {
+#ifdef IMPERIUM_X86_KERNELS
+        __builtin_cpu_init();
+        if (kernel == ScanKernel::AVX2 && __builtin_cpu_supports("avx2"))
+            return {ScanKernel::AVX2, avx2Whitespaces, avx2Digits, avx2Words, avx2Newlines, avx2InvalidUtf8};
+        if (kernel != ScanKernel::Scalar && __builtin_cpu_supports("sse2"))
+            return {ScanKernel::SSE2, sse2Whitespaces, sse2Digits, sse2Words, sse2Newlines, sse2InvalidUtf8};
+#endif
+        return {ScanKernel::Scalar, scalarWhitespace, scalarDigits, scalarWord, scalarNewlines, scalarInvalidUtf8};
+    }
+
+    ScanKernels activeKernels = kernelsFor(ScanKernel::AVX2);
+}
+
+namespace imperium_lang {
+
+    ScanKernel activeScanKernel() {
+        return activeKernels.kernel;
+    }
+
+    ScanKernel selectScanKernel(ScanKernel kernel) {
+        activeKernels = kernelsFor(kernel);
+        return activeKernels.kernel;
+    }
+
+    std::size_t scanWhitespace(std::string_view text) {
+        return activeKernels.whitespace(text);
+    }
+
+    std::size_t scanDigits(std::string_view text) {
+        return activeKernels.digits(text);
+    }
+
+    std::size_t scanWord(std::string_view text) {
+        return activeKernels.word(text);
+    }
+
+    void findNewlines(std::string_view text, std::vector<std::size_t>& offsets) {
+        activeKernels.newlines(text, offsets);
+    }
+
+    std::size_t findInvalidUtf8(std::string_view text) {
+        return activeKernels.invalidUtf8(text);
+    }
+
+}
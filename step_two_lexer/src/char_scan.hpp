@@ -0,0 +1,86 @@
+/**
+ * @file char_scan.hpp
+ * 
+ * @brief Include file for character class run scanning kernels
+ */
+
+#ifndef CHAR_SCAN_HPP
+#define CHAR_SCAN_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace imperium_lang {
+
+    /**
+     * @brief Instruction set used by the run scanning kernels
+     */
+    enum class ScanKernel {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+
+    /**
+     * @brief Provides the kernel picked for this CPU at startup
+     */
+    ScanKernel activeScanKernel();
+
+    /**
+     * @brief Forces a kernel, falling back to scalar if the CPU lacks it
+     * 
+     * @param[in] kernel The kernel to use from now on
+     * @return The kernel actually in use
+     */
+    ScanKernel selectScanKernel(ScanKernel kernel);
+
+    /**
+     * @brief Measures the run of `WHITESPACE` bytes at the start of `text`
+     * 
+     * @param[in] text The text to scan
+     * @return Length of the run
+     */
+    std::size_t scanWhitespace(std::string_view text);
+
+    /**
+     * @brief Measures the run of `DIGIT` bytes at the start of `text`
+     * 
+     * @param[in] text The text to scan
+     * @return Length of the run
+     */
+    std::size_t scanDigits(std::string_view text);
+
+    /**
+     * @brief Measures the run of `WORD_CHARACTER` and
+     *        `UTF8_SEQUENCE_BYTE` bytes at the start of `text`
+     * 
+     * @param[in] text The text to scan
+     * @return Length of the run
+     */
+    std::size_t scanWord(std::string_view text);
+
+    /**
+     * @brief Appends the offset of every `\n` byte in `text`
+     * 
+     * @param[in] text The text to scan
+     * @param[out] offsets Offsets of the newlines, in order
+     */
+    void findNewlines(std::string_view text, std::vector<std::size_t>& offsets);
+
+    /**
+     * @brief Finds the first byte of `text` that does not start a well
+     *        formed UTF-8 sequence
+     * 
+     * Blocks of pure ASCII are passed over a vector at a time; only blocks
+     * holding other bytes are decoded.
+     * 
+     * @param[in] text The text to check
+     * @return Offset of the malformed sequence, or `npos` if `text` is
+     *         valid UTF-8
+     */
+    std::size_t findInvalidUtf8(std::string_view text);
+
+}
+
+#endif
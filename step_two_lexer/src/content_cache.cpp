@@ -0,0 +1,236 @@
+/**
+ * @file content_cache.cpp
+ * 
+ * @brief Implementation file for the on-disk cache of results keyed by
+ *        source content
+ */
+
+#include "content_cache.hpp"
+#include "symbol_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr std::string_view TEMPORARY_EXTENSION = ".tmp";
+
+    /**
+     * @brief Provides a name no other thread or process is using for a
+     *        temporary file
+     * 
+     * @param[in] entry Path of the entry being written
+     */
+    std::filesystem::path temporaryPath(const std::filesystem::path& entry) {
+        static std::atomic<std::uint64_t> counter{0};
+        const auto unique = std::hash<std::thread::id>{}(std::this_thread::get_id())
+            ^ static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())
+            ^ (counter.fetch_add(1, std::memory_order_relaxed) << 48);
+        auto path = entry;
+        path += "." + std::to_string(unique);
+        path += TEMPORARY_EXTENSION;
+        return path;
+    }
+
+    /**
+     * @brief Checks that a file name is one `entryPath` hands out
+     * 
+     * Only such files count towards the size limit or get evicted, so
+     * anything else in the directory is left alone.
+     * 
+     * @param[in] name The file name
+     */
+    bool isEntryName(std::string_view name) {
+        constexpr auto isHex = [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); };
+        constexpr auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+        constexpr std::size_t HEX_LENGTH = 16;
+
+        // Hash and size, each followed by a dash
+        for (int field = 0; field < 2; ++field) {
+            if (name.size() <= HEX_LENGTH || !std::all_of(name.begin(), name.begin() + HEX_LENGTH, isHex) || name[HEX_LENGTH] != '-') {
+                return false;
+            }
+            name.remove_prefix(HEX_LENGTH + 1);
+        }
+
+        // Kind, then the version stamp
+        const auto stamp = name.rfind(".v");
+        if (stamp == 0 || stamp == std::string_view::npos || stamp + 2 == name.size()) {
+            return false;
+        }
+        const auto kind = name.substr(0, stamp);
+        const auto version = name.substr(stamp + 2);
+        return std::all_of(kind.begin(), kind.end(), [&](char c) { return (c >= 'a' && c <= 'z') || isDigit(c) || c == '-' || c == '_'; })
+            && std::all_of(version.begin(), version.end(), isDigit);
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Constructor
+     * 
+     * @param[in] directory The cache directory. Created on first store.
+     * @param[in] maxBytes Size the directory is trimmed back under
+     */
+    ContentCache::ContentCache(std::filesystem::path directory, std::uintmax_t maxBytes)
+        : directory(std::move(directory)), maxBytes(maxBytes) {}
+
+    /**
+     * @brief Provides the path of the entry for a source
+     * 
+     * @param[in] source The source the result was computed from
+     * @param[in] kind Name of the kind of result
+     * @param[in] version Version stamp of the code producing the result
+     */
+    std::filesystem::path ContentCache::entryPath(std::string_view source, std::string_view kind, std::uint32_t version) const {
+        constexpr std::string_view DIGITS = "0123456789abcdef";
+        std::string name;
+        for (const std::uint64_t value : {hashBytes(source), static_cast<std::uint64_t>(source.size())}) {
+            for (int shift = 60; shift >= 0; shift -= 4) {
+                name += DIGITS[(value >> shift) & 0xf];
+            }
+            name += '-';
+        }
+        name.append(kind);
+        name += ".v" + std::to_string(version);
+        return directory / name;
+    }
+
+    /**
+     * @brief Maps the entry for a source, if there is one
+     * 
+     * @param[in] source The source the result was computed from
+     * @param[in] kind Name of the kind of result
+     * @param[in] version Version stamp of the code producing the result
+     * @param[out] entry The entry's contents
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 There is no entry
+     */
+    int ContentCache::load(std::string_view source, std::string_view kind, std::uint32_t version, MappedFile& entry) {
+
+        const auto path = entryPath(source, kind, version);
+        if (entry.open(path.string()) != 0) {
+            return 1;
+        }
+
+        // Mark the entry as recently used for eviction
+        std::error_code error;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+        return 0;
+    }
+
+    /**
+     * @brief Writes the entry for a source, replacing any existing one
+     * 
+     * @param[in] source The source the result was computed from
+     * @param[in] kind Name of the kind of result
+     * @param[in] version Version stamp of the code producing the result
+     * @param[in] contents The entry's contents
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Write Error
+     */
+    int ContentCache::store(std::string_view source, std::string_view kind, std::uint32_t version, std::string_view contents) {
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        const auto path = entryPath(source, kind, version);
+        const auto temporary = temporaryPath(path);
+        {
+            std::ofstream out(temporary, std::ios::binary);
+            out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            out.close();
+            if (!out) {
+                std::filesystem::remove(temporary, error);
+                std::cerr << "Error: Failed to write cache entry.\n";
+                return -2;
+            }
+        }
+
+        // Renaming over the old entry is atomic, so readers never see half an entry
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            std::cerr << "Error: Failed to write cache entry.\n";
+            return -2;
+        }
+
+        bool overLimit;
+        {
+            std::lock_guard lock(sizeMutex);
+            knownBytes += contents.size();
+            overLimit = !scanned || knownBytes > maxBytes;
+        }
+
+        return overLimit ? evict() : 0;
+    }
+
+    /**
+     * @brief Removes the least recently used entries until the directory
+     *        is well under its size limit
+     * 
+     * Files not named like an entry, such as temporary files and anything
+     * else kept in the directory, are neither counted nor removed. Entries
+     * are trimmed to three quarters of the limit, so a busy cache
+     * is not rescanned on every store.
+     * 
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int ContentCache::evict() {
+
+        struct Entry {
+            std::filesystem::file_time_type lastUsed;
+            std::uintmax_t size;
+            std::filesystem::path path;
+        };
+
+        std::lock_guard lock(sizeMutex);
+        std::vector<Entry> entries;
+        std::uintmax_t total = 0;
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+            std::error_code entryError;
+            if (!it->is_regular_file(entryError) || !isEntryName(it->path().filename().string())) {
+                continue;
+            }
+            const auto size = it->file_size(entryError);
+            const auto lastUsed = it->last_write_time(entryError);
+            if (!entryError) {
+                entries.push_back(Entry{lastUsed, size, it->path()});
+                total += size;
+            }
+        }
+        if (error) {
+            std::cerr << "Error: Failed to read cache directory.\n";
+            return -2;
+        }
+        scanned = true;
+        if (total > maxBytes) {
+            std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+            const std::uintmax_t target = maxBytes / 4 * 3;
+            for (const auto& entry : entries) {
+                if (total <= target) {
+                    break;
+                }
+
+                // Another process may have removed it already, which is as good
+                std::filesystem::remove(entry.path, error);
+                total -= entry.size;
+            }
+        }
+        knownBytes = total;
+
+        return 0;
+    }
+
+}
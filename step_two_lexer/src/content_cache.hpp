@@ -0,0 +1,93 @@
+/**
+ * @file content_cache.hpp
+ * 
+ * @brief Include file for the on-disk cache of results keyed by source
+ *        content
+ */
+
+#ifndef CONTENT_CACHE_HPP
+#define CONTENT_CACHE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "mapped_file.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief A directory of results computed from source files, found again
+     *        by the content of the source rather than by its path
+     * 
+     * An entry is named by a hash of the source, the source's size, the kind
+     * of result and a version stamp of the code that produced it, so an
+     * edited file or a rebuilt tokenizer simply misses. Entries are written
+     * to a temporary file and renamed into place, so readers in other
+     * processes see either the whole entry or none of it. Once the
+     * directory grows past its size limit, the least recently used entries
+     * are removed. Other files in the directory are never counted or removed.
+     * 
+     * Lookups and stores may run on several threads at once.
+     */
+    class ContentCache {
+    private:
+        std::filesystem::path directory;
+        std::uintmax_t maxBytes;
+        std::mutex sizeMutex;
+        std::uintmax_t knownBytes = 0;
+        bool scanned = false;
+
+        std::filesystem::path entryPath(std::string_view source, std::string_view kind, std::uint32_t version) const;
+    public:
+        static constexpr std::uintmax_t DEFAULT_MAX_BYTES = std::uintmax_t{256} << 20;
+
+        /**
+         * @brief Constructor
+         * 
+         * @param[in] directory The cache directory. Created on first store.
+         * @param[in] maxBytes Size the directory is trimmed back under
+         */
+        explicit ContentCache(std::filesystem::path directory, std::uintmax_t maxBytes = DEFAULT_MAX_BYTES);
+
+        /**
+         * @brief Maps the entry for a source, if there is one
+         * 
+         * @param[in] source The source the result was computed from
+         * @param[in] kind Name of the kind of result
+         * @param[in] version Version stamp of the code producing the result
+         * @param[out] entry The entry's contents
+         * @return Status code
+         * @retval 0 Success
+         * @retval 1 There is no entry
+         */
+        int load(std::string_view source, std::string_view kind, std::uint32_t version, MappedFile& entry);
+
+        /**
+         * @brief Writes the entry for a source, replacing any existing one
+         * 
+         * @param[in] source The source the result was computed from
+         * @param[in] kind Name of the kind of result
+         * @param[in] version Version stamp of the code producing the result
+         * @param[in] contents The entry's contents
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Write Error
+         */
+        int store(std::string_view source, std::string_view kind, std::uint32_t version, std::string_view contents);
+
+        /**
+         * @brief Removes the least recently used entries until the directory
+         *        is well under its size limit
+         * 
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Read Error
+         */
+        int evict();
+    };
+
+}
+
+#endif
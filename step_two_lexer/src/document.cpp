@@ -0,0 +1,162 @@
+/**
+ * @file document.cpp
+ * 
+ * @brief Implementation file for incrementally re-lexed editor documents
+ */
+
+#include "document.hpp"
+#include "lexer_dfa.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    constexpr std::size_t MIN_GAP = 1024;
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Replaces the whole text and lexes it from scratch
+     * 
+     * @param[in] text The new text
+     */
+    void Document::open(std::string text) {
+
+        content = std::move(text);
+        storage.clear();
+        for (std::size_t pos = 0; pos < content.size();) {
+            storage.push_back(lexAt(pos));
+            pos += storage.back().length;
+        }
+        gapBegin = storage.size();
+        gapEnd = storage.size();
+    }
+
+    /**
+     * @brief Replaces a range of the text and re-lexes only what changed
+     * 
+     * @param[in] offset Start of the replaced range
+     * @param[in] removedLength Length of the replaced range
+     * @param[in] replacement Text to put in its place
+     * @param[out] change The token range the edit replaced
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 The range is outside the document
+     */
+    int Document::edit(std::size_t offset, std::size_t removedLength, std::string_view replacement, TokenChange& change) {
+
+        if (offset > content.size() || removedLength > content.size() - offset) {
+            return -1;
+        }
+
+        // The first token the edit can affect is the first one the DFA read
+        // past `offset` for, which includes the bytes it looked ahead at
+        std::size_t low = 0;
+        std::size_t high = tokenCount();
+        while (low < high) {
+            const std::size_t mid = (low + high) / 2;
+            const TokenView candidate = token(mid);
+            if (candidate.offset + candidate.length + LEXER_LOOKAHEAD <= offset) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        const std::size_t first = low;
+        const std::size_t restart = first < tokenCount() ? token(first).offset : content.size();
+
+        // Park the gap at the damage while the old text size still applies,
+        // then edit the text. Tokens after the gap stay valid relative to the end.
+        moveGap(first);
+        content.replace(offset, removedLength, replacement);
+        const std::size_t editEnd = offset + replacement.size();
+
+        // Re-lex until a new token boundary lands on an old token past the
+        // edit. Old tokens are compared by their distance from the end.
+        std::size_t pos = restart;
+        std::size_t old = gapEnd;
+        std::size_t inserted = 0;
+        while (true) {
+            const std::size_t remaining = content.size() - std::max(pos, editEnd);
+            while (old < storage.size() && storage[old].offset > remaining) {
+                ++old;
+            }
+            if (old < storage.size() && storage[old].offset == content.size() - pos) {
+                break;
+            }
+            if (pos >= content.size()) {
+                break;
+            }
+            if (gapBegin == gapEnd) {
+                const std::size_t oldGapEnd = gapEnd;
+                reserveGap(1);
+                old += gapEnd - oldGapEnd;
+            }
+            const TokenView fresh = lexAt(pos);
+            storage[gapBegin++] = fresh;
+            ++inserted;
+            pos += fresh.length;
+        }
+
+        change.firstToken = first;
+        change.removedCount = old - gapEnd;
+        change.insertedCount = inserted;
+        gapEnd = old;
+
+        return 0;
+    }
+
+    /**
+     * @brief Lexes one token of the document, falling back to a one byte
+     *        `Invalid` token
+     * 
+     * @param[in] offset Where the token starts
+     * @return The token
+     */
+    TokenView Document::lexAt(std::size_t offset) const {
+        TokenView token;
+        if (!lexToken(std::string_view(content).substr(offset), token)) {
+            token = TokenView{Invalid, 0, 1};
+        }
+        token.offset = offset;
+        return token;
+    }
+
+    /**
+     * @brief Moves the gap so that it sits before token `index`
+     * 
+     * @param[in] index Logical token index
+     */
+    void Document::moveGap(std::size_t index) {
+
+        // Tokens crossing the gap switch between absolute and end-relative offsets
+        while (gapBegin > index) {
+            TokenView moved = storage[--gapBegin];
+            moved.offset = content.size() - moved.offset;
+            storage[--gapEnd] = moved;
+        }
+        while (gapBegin < index) {
+            TokenView moved = storage[gapEnd++];
+            moved.offset = content.size() - moved.offset;
+            storage[gapBegin++] = moved;
+        }
+    }
+
+    /**
+     * @brief Makes room for at least `count` tokens in the gap
+     * 
+     * @param[in] count Number of tokens to fit
+     */
+    void Document::reserveGap(std::size_t count) {
+
+        if (gapEnd - gapBegin >= count) {
+            return;
+        }
+        const std::size_t after = storage.size() - gapEnd;
+        const std::size_t gap = std::max({count, MIN_GAP, storage.size() / 8});
+        storage.resize(gapBegin + gap + after);
+        std::move_backward(storage.begin() + gapEnd, storage.begin() + gapEnd + after, storage.end());
+        gapEnd = gapBegin + gap;
+    }
+
+}
@@ -0,0 +1,123 @@
+/**
+ * @file document.hpp
+ * 
+ * @brief Include file for incrementally re-lexed editor documents
+ */
+
+#ifndef DOCUMENT_HPP
+#define DOCUMENT_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "tokenizer.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief The tokens an edit replaced
+     * 
+     * Tokens `[firstToken, firstToken + removedCount)` of the old stream were
+     * replaced by tokens `[firstToken, firstToken + insertedCount)` of the
+     * new one. Tokens after them only moved.
+     */
+    struct TokenChange {
+        std::size_t firstToken = 0;
+        std::size_t removedCount = 0;
+        std::size_t insertedCount = 0;
+    };
+
+    /**
+     * @brief Source text and its tokens, kept up to date under edits
+     * 
+     * Bytes that start no valid token become one byte `Invalid` tokens, so
+     * a document can always be lexed while it is being typed. Identifiers
+     * are not interned and numbers are not decoded.
+     * 
+     * Tokens are stored in a gap buffer with the gap at the last edit.
+     * Tokens after the gap store their offset counted back from the end of
+     * the text, so an edit never has to shift the tokens that follow it.
+     */
+    class Document {
+    private:
+        std::string content;
+        std::vector<TokenView> storage;
+        std::size_t gapBegin = 0;
+        std::size_t gapEnd = 0;
+
+        /**
+         * @brief Lexes one token of the document, falling back to a one byte
+         *        `Invalid` token
+         * 
+         * @param[in] offset Where the token starts
+         * @return The token
+         */
+        TokenView lexAt(std::size_t offset) const;
+
+        /**
+         * @brief Moves the gap so that it sits before token `index`
+         * 
+         * @param[in] index Logical token index
+         */
+        void moveGap(std::size_t index);
+
+        /**
+         * @brief Makes room for at least `count` tokens in the gap
+         * 
+         * @param[in] count Number of tokens to fit
+         */
+        void reserveGap(std::size_t count);
+    public:
+        /**
+         * @brief Replaces the whole text and lexes it from scratch
+         * 
+         * @param[in] text The new text
+         */
+        void open(std::string text);
+
+        /**
+         * @brief Replaces a range of the text and re-lexes only what changed
+         * 
+         * Lexing restarts at the first token the edit can affect and stops
+         * as soon as a new token boundary lines up with an old token after
+         * the edit.
+         * 
+         * @param[in] offset Start of the replaced range
+         * @param[in] removedLength Length of the replaced range
+         * @param[in] replacement Text to put in its place
+         * @param[out] change The token range the edit replaced
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 The range is outside the document
+         */
+        int edit(std::size_t offset, std::size_t removedLength, std::string_view replacement, TokenChange& change);
+
+        /**
+         * @brief Provides the current text
+         */
+        std::string_view text() const { return content; }
+
+        /**
+         * @brief Provides the number of tokens
+         */
+        std::size_t tokenCount() const { return storage.size() - (gapEnd - gapBegin); }
+
+        /**
+         * @brief Provides a token with its absolute offset
+         * 
+         * @param[in] index Token index, below `tokenCount()`
+         */
+        TokenView token(std::size_t index) const {
+            if (index < gapBegin) {
+                return storage[index];
+            }
+            TokenView token = storage[index + (gapEnd - gapBegin)];
+            token.offset = content.size() - token.offset;
+            return token;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,430 @@
+/**
+ * @file json_rpc.cpp
+ * 
+ * @brief Implementation file for JSON values and JSON-RPC message framing
+ */
+
+#include "json_rpc.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    constexpr std::size_t MAX_JSON_DEPTH = 256;
+
+    /**
+     * @brief Recursive descent reader over one JSON document
+     */
+    class JsonReader {
+    private:
+        std::string_view text;
+        std::size_t position = 0;
+        std::size_t depth = 0;
+
+        void skipWhitespace() {
+            while (position < text.size() && (text[position] == ' ' || text[position] == '\t'
+                    || text[position] == '\n' || text[position] == '\r')) {
+                ++position;
+            }
+        }
+
+        bool consume(std::string_view literal) {
+            if (text.substr(position, literal.size()) != literal) {
+                return false;
+            }
+            position += literal.size();
+            return true;
+        }
+
+        /**
+         * @brief Reads four hex digits of a `\u` escape
+         */
+        bool readHex(std::uint32_t& unit) {
+            if (position + 4 > text.size()) {
+                return false;
+            }
+            const auto result = std::from_chars(text.data() + position, text.data() + position + 4, unit, 16);
+            if (result.ptr != text.data() + position + 4) {
+                return false;
+            }
+            position += 4;
+            return true;
+        }
+
+        static void appendUtf8(std::uint32_t codePoint, std::string& out) {
+            if (codePoint < 0x80) {
+                out += static_cast<char>(codePoint);
+            } else if (codePoint < 0x800) {
+                out += static_cast<char>(0xC0 | codePoint >> 6);
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                out += static_cast<char>(0xE0 | codePoint >> 12);
+                out += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | codePoint >> 18);
+                out += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+        bool readString(std::string& out) {
+            ++position;
+            while (position < text.size()) {
+                const char c = text[position++];
+                if (c == '"') {
+                    return true;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    return false;
+                } else if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (position == text.size()) {
+                    return false;
+                }
+                switch (text[position++]) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        std::uint32_t unit = 0;
+                        if (!readHex(unit)) {
+                            return false;
+                        }
+
+                        // A high surrogate only counts when a low one follows
+                        std::uint32_t low = 0;
+                        if (unit >= 0xD800 && unit < 0xDC00 && consume("\\u") && readHex(low) && low >= 0xDC00 && low < 0xE000) {
+                            unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                        } else if (unit >= 0xD800 && unit < 0xE000) {
+                            return false;
+                        }
+                        appendUtf8(unit, out);
+                        break;
+                    }
+                    default: return false;
+                }
+            }
+            return false;
+        }
+
+        bool readNumber(double& number) {
+            const std::size_t start = position;
+            if (position < text.size() && text[position] == '-') {
+                ++position;
+            }
+            while (position < text.size() && ((text[position] >= '0' && text[position] <= '9')
+                    || text[position] == '.' || text[position] == 'e' || text[position] == 'E'
+                    || text[position] == '+' || text[position] == '-')) {
+                ++position;
+            }
+            const auto result = std::from_chars(text.data() + start, text.data() + position, number);
+            return result.ec == std::errc{} && result.ptr == text.data() + position && std::isfinite(number);
+        }
+
+        bool readValue(imperium_lang::JsonValue& value) {
+            using imperium_lang::JsonKind;
+            skipWhitespace();
+            if (position == text.size() || depth == MAX_JSON_DEPTH) {
+                return false;
+            }
+            switch (text[position]) {
+                case 'n':
+                    value.kind = JsonKind::Null;
+                    return consume("null");
+                case 't':
+                    value.kind = JsonKind::Bool;
+                    value.boolean = true;
+                    return consume("true");
+                case 'f':
+                    value.kind = JsonKind::Bool;
+                    value.boolean = false;
+                    return consume("false");
+                case '"':
+                    value.kind = JsonKind::String;
+                    return readString(value.string);
+                case '[': {
+                    value.kind = JsonKind::Array;
+                    ++position;
+                    ++depth;
+                    skipWhitespace();
+                    if (consume("]")) {
+                        --depth;
+                        return true;
+                    }
+                    do {
+                        value.array.emplace_back();
+                        if (!readValue(value.array.back())) {
+                            return false;
+                        }
+                        skipWhitespace();
+                    } while (consume(","));
+                    --depth;
+                    return consume("]");
+                }
+                case '{': {
+                    value.kind = JsonKind::Object;
+                    ++position;
+                    ++depth;
+                    skipWhitespace();
+                    if (consume("}")) {
+                        --depth;
+                        return true;
+                    }
+                    do {
+                        skipWhitespace();
+                        value.object.emplace_back();
+                        auto& member = value.object.back();
+                        if (position == text.size() || text[position] != '"' || !readString(member.first)) {
+                            return false;
+                        }
+                        skipWhitespace();
+                        if (!consume(":") || !readValue(member.second)) {
+                            return false;
+                        }
+                        skipWhitespace();
+                    } while (consume(","));
+                    --depth;
+                    return consume("}");
+                }
+                default:
+                    value.kind = JsonKind::Number;
+                    return readNumber(value.number);
+            }
+        }
+    public:
+        explicit JsonReader(std::string_view text) : text(text) {}
+
+        bool readDocument(imperium_lang::JsonValue& value) {
+            if (!readValue(value)) {
+                return false;
+            }
+            skipWhitespace();
+            return position == text.size();
+        }
+    };
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Finds an object member
+     * 
+     * @param[in] key Name of the member
+     * @return The member, or null if this is not an object or has no
+     *         such member
+     */
+    const JsonValue* JsonValue::find(std::string_view key) const {
+        for (const auto& member : object) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Provides a string member's text
+     * 
+     * @param[in] key Name of the member
+     * @return The text, or an empty view if there is no such string
+     */
+    std::string_view JsonValue::stringAt(std::string_view key) const {
+        const JsonValue* member = find(key);
+        return member != nullptr && member->kind == JsonKind::String ? std::string_view(member->string) : std::string_view{};
+    }
+
+    /**
+     * @brief Provides a number member as an unsigned integer
+     * 
+     * @param[in] key Name of the member
+     * @param[out] value The number
+     * @return Whether the member is a non-negative integer
+     */
+    bool JsonValue::unsignedAt(std::string_view key, std::size_t& value) const {
+        const JsonValue* member = find(key);
+        if (member == nullptr || member->kind != JsonKind::Number || member->number < 0.0
+                || member->number != std::floor(member->number) || member->number > 9007199254740992.0) {
+            return false;
+        }
+        value = static_cast<std::size_t>(member->number);
+        return true;
+    }
+
+    /**
+     * @brief Parses a JSON document
+     * 
+     * @param[in] text The document
+     * @param[out] value The value it holds
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int parseJson(std::string_view text, JsonValue& value) {
+        value = JsonValue{};
+        if (!JsonReader(text).readDocument(value)) {
+            value = JsonValue{};
+            return -1;
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Appends the JSON text of a value
+     * 
+     * Numbers that are whole are written without a fraction.
+     * 
+     * @param[in] value The value to write
+     * @param[in, out] out The text to append to
+     */
+    void writeJson(const JsonValue& value, std::string& out) {
+        switch (value.kind) {
+            case JsonKind::Null:
+                out += "null";
+                break;
+            case JsonKind::Bool:
+                out += value.boolean ? "true" : "false";
+                break;
+            case JsonKind::Number: {
+                char digits[32];
+                const auto result = std::to_chars(digits, digits + sizeof(digits), value.number);
+                out.append(digits, result.ptr);
+                break;
+            }
+            case JsonKind::String:
+                writeJsonString(value.string, out);
+                break;
+            case JsonKind::Array:
+                out += '[';
+                for (std::size_t i = 0; i < value.array.size(); ++i) {
+                    if (i != 0) {
+                        out += ',';
+                    }
+                    writeJson(value.array[i], out);
+                }
+                out += ']';
+                break;
+            case JsonKind::Object:
+                out += '{';
+                for (std::size_t i = 0; i < value.object.size(); ++i) {
+                    if (i != 0) {
+                        out += ',';
+                    }
+                    writeJsonString(value.object[i].first, out);
+                    out += ':';
+                    writeJson(value.object[i].second, out);
+                }
+                out += '}';
+                break;
+        }
+    }
+
+    /**
+     * @brief Appends a string as a quoted JSON string
+     * 
+     * @param[in] text The string to write
+     * @param[in, out] out The text to append to
+     */
+    void writeJsonString(std::string_view text, std::string& out) {
+        out += '"';
+        for (const char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escape[8];
+                        std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+                        out += escape;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    /**
+     * @brief Reads one message framed by a `Content-Length` header
+     * 
+     * Header lines other than `Content-Length` are skipped.
+     * 
+     * @param[in, out] in The stream to read from
+     * @param[out] body The message body
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 End of file reached before a message started
+     * @retval -1 The header is malformed
+     * @retval -2 Read Error
+     */
+    int readRpcMessage(std::istream& in, std::string& body) {
+        constexpr std::string_view LENGTH_FIELD = "Content-Length:";
+        std::string line;
+        std::size_t length = 0;
+        bool lengthFound = false;
+        bool started = false;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                if (!started) {
+                    continue;
+                }
+                break;
+            }
+            started = true;
+            if (line.size() > LENGTH_FIELD.size() && line.compare(0, LENGTH_FIELD.size(), LENGTH_FIELD) == 0) {
+                std::size_t start = LENGTH_FIELD.size();
+                while (start < line.size() && line[start] == ' ') {
+                    ++start;
+                }
+                const auto result = std::from_chars(line.data() + start, line.data() + line.size(), length);
+                lengthFound = result.ec == std::errc{} && result.ptr == line.data() + line.size();
+            }
+        }
+        if (!started) {
+            return in.bad() ? -2 : 1;
+        } else if (!in) {
+            return in.bad() ? -2 : -1;
+        } else if (!lengthFound) {
+            return -1;
+        }
+        body.resize(length);
+        if (!in.read(body.data(), static_cast<std::streamsize>(length))) {
+            return -2;
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Writes one message framed by a `Content-Length` header and
+     *        flushes it
+     * 
+     * @param[in, out] out The stream to write to
+     * @param[in] body The message body
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Write Error
+     */
+    int writeRpcMessage(std::ostream& out, std::string_view body) {
+        out << "Content-Length: " << body.size() << "\r\n\r\n";
+        out.write(body.data(), static_cast<std::streamsize>(body.size()));
+        out.flush();
+
+        return out ? 0 : -2;
+    }
+
+}
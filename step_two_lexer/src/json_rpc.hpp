@@ -0,0 +1,128 @@
+/**
+ * @file json_rpc.hpp
+ * 
+ * @brief Include file for JSON values and JSON-RPC message framing
+ */
+
+#ifndef JSON_RPC_HPP
+#define JSON_RPC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace imperium_lang {
+
+    /**
+     * @brief What a JSON value holds
+     */
+    enum class JsonKind : std::uint8_t {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    /**
+     * @brief A parsed JSON value
+     * 
+     * Only the member matching `kind` is set. Object members keep the
+     * order they were written in.
+     */
+    struct JsonValue {
+        JsonKind kind = JsonKind::Null;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<JsonValue> array;
+        std::vector<std::pair<std::string, JsonValue>> object;
+
+        /**
+         * @brief Finds an object member
+         * 
+         * @param[in] key Name of the member
+         * @return The member, or null if this is not an object or has no
+         *         such member
+         */
+        const JsonValue* find(std::string_view key) const;
+
+        /**
+         * @brief Provides a string member's text
+         * 
+         * @param[in] key Name of the member
+         * @return The text, or an empty view if there is no such string
+         */
+        std::string_view stringAt(std::string_view key) const;
+
+        /**
+         * @brief Provides a number member as an unsigned integer
+         * 
+         * @param[in] key Name of the member
+         * @param[out] value The number
+         * @return Whether the member is a non-negative integer
+         */
+        bool unsignedAt(std::string_view key, std::size_t& value) const;
+    };
+
+    /**
+     * @brief Parses a JSON document
+     * 
+     * @param[in] text The document
+     * @param[out] value The value it holds
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int parseJson(std::string_view text, JsonValue& value);
+
+    /**
+     * @brief Appends the JSON text of a value
+     * 
+     * @param[in] value The value to write
+     * @param[in, out] out The text to append to
+     */
+    void writeJson(const JsonValue& value, std::string& out);
+
+    /**
+     * @brief Appends a string as a quoted JSON string
+     * 
+     * @param[in] text The string to write
+     * @param[in, out] out The text to append to
+     */
+    void writeJsonString(std::string_view text, std::string& out);
+
+    /**
+     * @brief Reads one message framed by a `Content-Length` header
+     * 
+     * @param[in, out] in The stream to read from
+     * @param[out] body The message body
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 End of file reached before a message started
+     * @retval -1 The header is malformed
+     * @retval -2 Read Error
+     */
+    int readRpcMessage(std::istream& in, std::string& body);
+
+    /**
+     * @brief Writes one message framed by a `Content-Length` header and
+     *        flushes it
+     * 
+     * @param[in, out] out The stream to write to
+     * @param[in] body The message body
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Write Error
+     */
+    int writeRpcMessage(std::ostream& out, std::string_view body);
+
+}
+
+#endif
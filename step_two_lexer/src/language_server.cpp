@@ -0,0 +1,736 @@
+/**
+ * @file language_server.cpp
+ * 
+ * @brief Implementation file for the language server that keeps open
+ *        documents lexed in memory
+ */
+
+#include "language_server.hpp"
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+    // JSON-RPC and LSP error codes
+    constexpr int PARSE_ERROR = -32700;
+    constexpr int INVALID_REQUEST = -32600;
+    constexpr int METHOD_NOT_FOUND = -32601;
+    constexpr int INVALID_PARAMS = -32602;
+    constexpr int SERVER_NOT_INITIALIZED = -32002;
+
+    // Legend of the semantic token types, indexed by the numbers sent
+    constexpr std::string_view SEMANTIC_TOKEN_TYPES[] = {"keyword", "variable", "operator", "number", "comment"};
+    constexpr std::uint32_t NO_SEMANTIC_TYPE = UINT32_MAX;
+
+    /**
+     * @brief Provides the semantic token type of a token
+     * 
+     * @param[in] type The token's type
+     * @return Index into `SEMANTIC_TOKEN_TYPES`
+     * @retval NO_SEMANTIC_TYPE The token is not highlighted
+     */
+    constexpr std::uint32_t semanticTokenType(imperium_lang::TokenType type) {
+        switch (type) {
+            case imperium_lang::ReservedWord: return 0;
+            case imperium_lang::CharSequence: return 1;
+            case imperium_lang::OperatorSequence: return 2;
+            case imperium_lang::Number: return 3;
+            case imperium_lang::Comment: return 4;
+            default: return NO_SEMANTIC_TYPE;
+        }
+    }
+
+    /**
+     * @brief Provides how many column units a byte of UTF-8 text adds
+     * 
+     * Continuation bytes add nothing, and a code point outside the basic
+     * plane takes two UTF-16 units.
+     * 
+     * @param[in] c The byte
+     * @param[in] encoding How columns are counted
+     */
+    constexpr std::size_t columnUnits(char c, imperium_lang::PositionEncoding encoding) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (encoding == imperium_lang::PositionEncoding::Utf8) {
+            return 1;
+        }
+        return (byte & 0xC0) == 0x80 ? 0 : byte >= 0xF0 ? 2 : 1;
+    }
+
+    using SemanticEntry = imperium_lang::SemanticTokenCache::Entry;
+
+    /**
+     * @brief Encodes tokens in the relative form of LSP semantic tokens
+     * 
+     * Tokens must be added in order. The text between them is walked once
+     * to keep track of the line and column, and tokens spanning lines are
+     * split into one entry per line.
+     */
+    class SemanticTokenEncoder {
+    private:
+        std::string_view text;
+        imperium_lang::PositionEncoding encoding;
+        std::vector<SemanticEntry>& entries;
+        std::size_t cursor;
+        std::size_t line;
+        std::size_t column = 0;
+        std::size_t previousLine = 0;
+        std::size_t previousColumn = 0;
+
+        void advanceTo(std::size_t offset) {
+            for (; cursor < offset; ++cursor) {
+                if (text[cursor] == '\n') {
+                    ++line;
+                    column = 0;
+                } else {
+                    column += columnUnits(text[cursor], encoding);
+                }
+            }
+        }
+    public:
+        /**
+         * @brief Constructor
+         * 
+         * The first entry is encoded relative to the origin, which is
+         * either the entry before it or the start of the text. When it is
+         * the start of a line instead, `line` says which.
+         * 
+         * @param[in] text The document's text
+         * @param[in] encoding How columns are counted
+         * @param[out] entries The encoded tokens, appended to
+         * @param[in] origin Offset the first entry is encoded relative to
+         * @param[in] line Zero-based line number of a line start origin
+         */
+        SemanticTokenEncoder(std::string_view text, imperium_lang::PositionEncoding encoding, std::vector<SemanticEntry>& entries,
+            std::size_t origin = 0, std::size_t line = 0)
+            : text(text), encoding(encoding), entries(entries), cursor(origin), line(line) {}
+
+        void add(const imperium_lang::TokenView& token, std::uint32_t type) {
+            const std::size_t end = token.offset + token.length;
+            advanceTo(token.offset);
+            while (cursor < end) {
+                const std::size_t segmentStart = cursor;
+                const std::size_t segmentEnd = std::min(text.find('\n', cursor), end);
+                const std::size_t startLine = line;
+                const std::size_t startColumn = column;
+                advanceTo(segmentEnd);
+                if (column > startColumn) {
+                    entries.push_back(SemanticEntry{segmentStart,
+                        static_cast<std::uint32_t>(startLine - previousLine),
+                        static_cast<std::uint32_t>(startLine == previousLine ? startColumn - previousColumn : startColumn),
+                        static_cast<std::uint32_t>(column - startColumn), type});
+                    previousLine = startLine;
+                    previousColumn = startColumn;
+                }
+                if (segmentEnd < end) {
+                    advanceTo(segmentEnd + 1);
+                }
+            }
+        }
+
+        /**
+         * @brief Re-encodes an existing entry to follow the last one added
+         * 
+         * @param[in, out] entry The entry
+         * @param[in] offset Where the entry starts
+         */
+        void relink(SemanticEntry& entry, std::size_t offset) {
+            advanceTo(offset);
+            entry.deltaLine = static_cast<std::uint32_t>(line - previousLine);
+            entry.deltaStart = static_cast<std::uint32_t>(line == previousLine ? column - previousColumn : column);
+        }
+    };
+
+    /**
+     * @brief Appends one entry as the five numbers LSP expects
+     * 
+     * @param[in] entry The entry
+     * @param[in] first Whether it is the first element of its array
+     * @param[in, out] out The text to append to
+     */
+    void writeEntry(const SemanticEntry& entry, bool first, std::string& out) {
+        char digits[16];
+        for (const std::uint32_t number : {entry.deltaLine, entry.deltaStart, entry.length, entry.type, std::uint32_t{0}}) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+        }
+    }
+
+    /**
+     * @brief Provides the document URI in a request's parameters
+     * 
+     * @param[in] params The `params` member, possibly null
+     */
+    std::string_view documentUri(const imperium_lang::JsonValue* params) {
+        const imperium_lang::JsonValue* document = params != nullptr ? params->find("textDocument") : nullptr;
+        return document != nullptr ? document->stringAt("uri") : std::string_view{};
+    }
+
+    /**
+     * @brief Whether a change replaces the whole text rather than a range
+     */
+    bool replacesAll(const imperium_lang::JsonValue& change) {
+        return change.find("range") == nullptr;
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Moves the gap so that it sits before the first entry at or
+     *        after a byte offset
+     * 
+     * @param[in] offset Byte offset before the edit
+     * @param[in] textSize Size of the text before the edit
+     */
+    void SemanticTokenCache::moveGap(std::size_t offset, std::size_t textSize) {
+
+        // Entries crossing the gap switch between absolute and end-relative offsets
+        while (gapBegin > 0 && storage[gapBegin - 1].offset >= offset) {
+            Entry moved = storage[--gapBegin];
+            moved.offset = textSize - moved.offset;
+            storage[--gapEnd] = moved;
+        }
+        while (gapEnd < storage.size() && textSize - storage[gapEnd].offset < offset) {
+            Entry moved = storage[gapEnd++];
+            moved.offset = textSize - moved.offset;
+            storage[gapBegin++] = moved;
+        }
+    }
+
+    /**
+     * @brief Makes room for at least `count` entries in the gap
+     * 
+     * @param[in] count Number of entries to fit
+     */
+    void SemanticTokenCache::reserveGap(std::size_t count) {
+
+        if (gapEnd - gapBegin >= count) {
+            return;
+        }
+        const std::size_t after = storage.size() - gapEnd;
+        const std::size_t gap = std::max({count, std::size_t{64}, storage.size() / 8});
+        storage.resize(gapBegin + gap + after);
+        std::move_backward(storage.begin() + gapEnd, storage.begin() + gapEnd + after, storage.end());
+        gapEnd = gapBegin + gap;
+    }
+
+    /**
+     * @brief Notes that entries from `begin` up to the last `suffix`
+     *        entries no longer match what was sent
+     */
+    void SemanticTokenCache::markChanged(std::size_t begin, std::size_t suffix) {
+        changedBegin = changed ? std::min(changedBegin, begin) : begin;
+        unchangedSuffix = changed ? std::min(unchangedSuffix, suffix) : suffix;
+        changed = true;
+    }
+
+    /**
+     * @brief Encodes every token of a document from scratch
+     * 
+     * @param[in] document The document
+     * @param[in] encoding How columns are counted
+     */
+    void SemanticTokenCache::rebuild(const Document& document, PositionEncoding encoding) {
+        storage.clear();
+        SemanticTokenEncoder encoder(document.text(), encoding, storage);
+        for (std::size_t i = 0; i < document.tokenCount(); ++i) {
+            const TokenView token = document.token(i);
+            const std::uint32_t type = semanticTokenType(token.type);
+            if (type != NO_SEMANTIC_TYPE) {
+                encoder.add(token, type);
+            }
+        }
+        gapBegin = storage.size();
+        gapEnd = storage.size();
+        changed = false;
+        markChanged(0, 0);
+    }
+
+    /**
+     * @brief Re-encodes the entries of the tokens an edit replaced
+     * 
+     * @param[in] document The document, after the edit
+     * @param[in] encoding How columns are counted
+     * @param[in] change The token range the edit replaced
+     * @param[in] oldSize Size of the text before the edit
+     */
+    void SemanticTokenCache::update(const Document& document, PositionEncoding encoding, const TokenChange& change, std::size_t oldSize) {
+
+        const std::string_view text = document.text();
+        const std::size_t insertedEnd = change.firstToken + change.insertedCount;
+        const std::size_t begin = change.firstToken < document.tokenCount() ? document.token(change.firstToken).offset : text.size();
+        const std::size_t endFromBack = insertedEnd < document.tokenCount() ? text.size() - document.token(insertedEnd).offset : 0;
+
+        // Drop the entries of the replaced tokens. Entries of the tokens that
+        // only moved keep their distance from the end.
+        moveGap(begin, oldSize);
+        const std::size_t removedFrom = gapBegin;
+        while (gapEnd < storage.size() && storage[gapEnd].offset > endFromBack) {
+            ++gapEnd;
+        }
+
+        // Encode the new tokens relative to the entry before them
+        std::vector<Entry> added;
+        SemanticTokenEncoder encoder(text, encoding, added, gapBegin > 0 ? storage[gapBegin - 1].offset : 0);
+        for (std::size_t i = change.firstToken; i < insertedEnd; ++i) {
+            const TokenView token = document.token(i);
+            const std::uint32_t type = semanticTokenType(token.type);
+            if (type != NO_SEMANTIC_TYPE) {
+                encoder.add(token, type);
+            }
+        }
+        reserveGap(added.size());
+        std::copy(added.begin(), added.end(), storage.begin() + gapBegin);
+        gapBegin += added.size();
+
+        // The entry after them now follows a different one
+        std::size_t suffix = 0;
+        if (gapEnd < storage.size()) {
+            encoder.relink(storage[gapEnd], text.size() - storage[gapEnd].offset);
+            suffix = storage.size() - gapEnd - 1;
+        }
+        markChanged(removedFrom, suffix);
+    }
+
+    /**
+     * @brief Appends every entry as a JSON array of numbers
+     * 
+     * @param[in, out] out The text to append to
+     */
+    void SemanticTokenCache::writeAll(std::string& out) const {
+        out += '[';
+        for (std::size_t i = 0; i < gapBegin; ++i) {
+            writeEntry(storage[i], i == 0, out);
+        }
+        for (std::size_t i = gapEnd; i < storage.size(); ++i) {
+            writeEntry(storage[i], i == gapEnd && gapBegin == 0, out);
+        }
+        out += ']';
+    }
+
+    /**
+     * @brief Appends the edits turning the entries last sent into the
+     *        current ones as a JSON array
+     * 
+     * Everything that changed is sent as one edit, from the first changed
+     * entry up to the unchanged suffix.
+     * 
+     * @param[in, out] out The text to append to
+     */
+    void SemanticTokenCache::writeEdits(std::string& out) const {
+        out += '[';
+        if (changed) {
+            const std::size_t end = size() - unchangedSuffix;
+            out += R"({"start":)" + std::to_string(changedBegin * 5) + R"(,"deleteCount":)"
+                + std::to_string((sentSize - changedBegin - unchangedSuffix) * 5) + R"(,"data":[)";
+            for (std::size_t i = changedBegin; i < end; ++i) {
+                writeEntry(storage[i < gapBegin ? i : i + (gapEnd - gapBegin)], i == changedBegin, out);
+            }
+            out += "]}";
+        }
+        out += ']';
+    }
+
+    /**
+     * @brief Records the current entries as sent
+     */
+    void SemanticTokenCache::markSent() {
+        changed = false;
+        sentSize = size();
+    }
+
+    /**
+     * @brief Serves messages read from a stream until the client exits
+     *        or the stream ends
+     * 
+     * After each message, every further message already buffered is read
+     * too and the lot is handled as one batch.
+     * 
+     * @param[in, out] in Stream messages are read from
+     * @return Status code
+     * @retval 0 The client sent `shutdown` and then `exit`
+     * @retval 1 The client exited without `shutdown` or the stream ended
+     * @retval -2 Read or write error
+     */
+    int LanguageServer::run(std::istream& in) {
+
+        std::vector<std::string> batch;
+        int readStatus = 0;
+        while (!exitRequested && readStatus == 0) {
+            batch.resize(1);
+            readStatus = readRpcMessage(in, batch.front());
+            if (readStatus != 0) {
+                break;
+            }
+            while (in.rdbuf()->in_avail() > 0) {
+                batch.emplace_back();
+                readStatus = readRpcMessage(in, batch.back());
+                if (readStatus != 0) {
+                    batch.pop_back();
+                    break;
+                }
+            }
+            if (handleBatch(batch) != 0) {
+                return -2;
+            }
+        }
+        if (readStatus == -1) {
+            std::cerr << "Error: Malformed message header.\n";
+            return -2;
+        } else if (readStatus == -2) {
+            std::cerr << "Error: Failed to read message.\n";
+            return -2;
+        }
+
+        return exitRequested && shutdownRequested ? 0 : 1;
+    }
+
+    /**
+     * @brief Handles a batch of message bodies in order
+     * 
+     * @param[in] bodies The JSON text of each message
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Write Error
+     */
+    int LanguageServer::handleBatch(const std::vector<std::string>& bodies) {
+
+        std::vector<JsonValue> messages(bodies.size());
+        std::vector<char> parsed(bodies.size());
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            parsed[i] = parseJson(bodies[i], messages[i]) == 0 && messages[i].kind == JsonKind::Object;
+        }
+
+        // Walk back from the end to find changes a later whole-text change
+        // makes moot. Requests in between must see the text at their turn.
+        std::vector<char> superseded(bodies.size(), false);
+        std::unordered_map<std::string_view, bool> replaced;
+        for (std::size_t i = bodies.size(); i-- > 0;) {
+            if (!parsed[i] || messages[i].find("id") != nullptr) {
+                replaced.clear();
+                continue;
+            }
+            const std::string_view method = messages[i].stringAt("method");
+            const JsonValue* params = messages[i].find("params");
+            const std::string_view uri = documentUri(params);
+            if (method == "textDocument/didChange" && !uri.empty()) {
+                const JsonValue* changes = params->find("contentChanges");
+                if (replaced[uri]) {
+                    superseded[i] = true;
+                } else if (changes != nullptr && std::any_of(changes->array.begin(), changes->array.end(), replacesAll)) {
+                    replaced[uri] = true;
+                }
+            } else if (!uri.empty()) {
+                replaced[uri] = false;
+            }
+        }
+
+        for (std::size_t i = 0; i < bodies.size() && !exitRequested; ++i) {
+            if (!parsed[i]) {
+                respondError(JsonValue{}, PARSE_ERROR, "Parse error");
+                continue;
+            }
+            handle(messages[i], superseded[i]);
+        }
+
+        return writeStatus;
+    }
+
+    /**
+     * @brief Handles one request or notification
+     * 
+     * @param[in] message The parsed message
+     * @param[in] skipChange Whether a change notification in it is
+     *            superseded and need not be applied
+     */
+    void LanguageServer::handle(const JsonValue& message, bool skipChange) {
+
+        const JsonValue* id = message.find("id");
+        const std::string_view method = message.stringAt("method");
+        const JsonValue* params = message.find("params");
+        if (method.empty()) {
+            // Responses to requests are not expected, as none are sent
+            if (id != nullptr && message.find("result") == nullptr && message.find("error") == nullptr) {
+                respondError(*id, INVALID_REQUEST, "Invalid request");
+            }
+            return;
+        } else if (method == "exit") {
+            exitRequested = true;
+            return;
+        } else if (!initialized && method != "initialize") {
+            if (id != nullptr) {
+                respondError(*id, SERVER_NOT_INITIALIZED, "Server not initialized");
+            }
+            return;
+        } else if (shutdownRequested && id != nullptr) {
+            respondError(*id, INVALID_REQUEST, "Server is shutting down");
+            return;
+        }
+
+        if (method == "initialize" && id != nullptr) {
+            const JsonValue* capabilities = params != nullptr ? params->find("capabilities") : nullptr;
+            const JsonValue* general = capabilities != nullptr ? capabilities->find("general") : nullptr;
+            const JsonValue* encodings = general != nullptr ? general->find("positionEncodings") : nullptr;
+            encoding = PositionEncoding::Utf16;
+            if (encodings != nullptr && std::any_of(encodings->array.begin(), encodings->array.end(),
+                    [](const JsonValue& value) { return value.string == "utf-8"; })) {
+                encoding = PositionEncoding::Utf8;
+            }
+            initialized = true;
+
+            std::string result = R"({"capabilities":{"positionEncoding":)";
+            result += encoding == PositionEncoding::Utf8 ? R"("utf-8")" : R"("utf-16")";
+            result += R"(,"textDocumentSync":{"openClose":true,"change":2},"semanticTokensProvider":{"legend":{"tokenTypes":[)";
+            for (std::size_t i = 0; i < std::size(SEMANTIC_TOKEN_TYPES); ++i) {
+                if (i != 0) {
+                    result += ',';
+                }
+                writeJsonString(SEMANTIC_TOKEN_TYPES[i], result);
+            }
+            result += R"(],"tokenModifiers":[]},"full":{"delta":true},"range":true}},"serverInfo":{"name":"imperium-lang"}})";
+            respond(*id, result);
+        } else if (method == "initialized") {
+        } else if (method == "shutdown" && id != nullptr) {
+            shutdownRequested = true;
+            respond(*id, "null");
+        } else if (method == "textDocument/didOpen") {
+            const JsonValue* document = params != nullptr ? params->find("textDocument") : nullptr;
+            if (document == nullptr || document->stringAt("uri").empty()) {
+                return;
+            }
+            OpenDocument& open = documents[std::string(document->stringAt("uri"))];
+            open.document.open(std::string(document->stringAt("text")));
+            open.lines.reset(open.document.text());
+            open.semanticTokens.rebuild(open.document, encoding);
+            open.resultId = 0;
+            const JsonValue* version = document->find("version");
+            open.version = version != nullptr ? static_cast<std::int64_t>(version->number) : 0;
+        } else if (method == "textDocument/didChange") {
+            OpenDocument* open = findDocument(params);
+            const JsonValue* changes = params != nullptr ? params->find("contentChanges") : nullptr;
+            if (open == nullptr || changes == nullptr) {
+                return;
+            }
+            const JsonValue* version = params->find("textDocument")->find("version");
+            if (version != nullptr) {
+                open->version = static_cast<std::int64_t>(version->number);
+            }
+            if (!skipChange) {
+                applyChanges(*open, *changes);
+            }
+        } else if (method == "textDocument/didClose") {
+            documents.erase(std::string(documentUri(params)));
+        } else if (method.starts_with("textDocument/semanticTokens/") && id != nullptr) {
+            OpenDocument* open = findDocument(params);
+            if (open == nullptr) {
+                respondError(*id, INVALID_PARAMS, "Unknown document");
+                return;
+            }
+            std::string result;
+            if (method == "textDocument/semanticTokens/range") {
+                const JsonValue* range = params->find("range");
+                std::size_t start;
+                std::size_t end;
+                if (range == nullptr || !offsetAt(*open, range->find("start"), start) || !offsetAt(*open, range->find("end"), end)) {
+                    respondError(*id, INVALID_PARAMS, "Invalid range");
+                    return;
+                }
+
+                // Find the first token ending after the start of the range
+                const Document& document = open->document;
+                std::size_t low = 0;
+                std::size_t high = document.tokenCount();
+                while (low < high) {
+                    const std::size_t mid = (low + high) / 2;
+                    const TokenView candidate = document.token(mid);
+                    if (candidate.offset + candidate.length <= start) {
+                        low = mid + 1;
+                    } else {
+                        high = mid;
+                    }
+                }
+                std::vector<SemanticEntry> entries;
+                if (low < document.tokenCount()) {
+                    const SourceLocation location = open->lines.locate(document.token(low).offset);
+                    const std::string_view line = open->lines.lineText(location.line);
+                    SemanticTokenEncoder encoder(document.text(), encoding, entries,
+                        static_cast<std::size_t>(line.data() - document.text().data()), location.line - 1);
+                    for (std::size_t i = low; i < document.tokenCount(); ++i) {
+                        const TokenView token = document.token(i);
+                        if (token.offset >= end && token.offset > start) {
+                            break;
+                        }
+                        const std::uint32_t type = semanticTokenType(token.type);
+                        if (type != NO_SEMANTIC_TYPE) {
+                            encoder.add(token, type);
+                        }
+                    }
+                }
+                result = R"({"data":[)";
+                for (std::size_t i = 0; i < entries.size(); ++i) {
+                    writeEntry(entries[i], i == 0, result);
+                }
+                result += "]}";
+                respond(*id, result);
+                return;
+            }
+
+            const bool deltaRequested = method == "textDocument/semanticTokens/full/delta";
+            if (!deltaRequested && method != "textDocument/semanticTokens/full") {
+                respondError(*id, METHOD_NOT_FOUND, "Method not found");
+                return;
+            }
+
+            // A delta needs the client to hold the tokens last sent
+            const bool delta = deltaRequested && open->resultId != 0
+                && params->stringAt("previousResultId") == std::to_string(open->resultId);
+            if (open->resultId == 0 || open->semanticTokens.changedSinceSent()) {
+                open->resultId = nextResultId++;
+            }
+            result = R"({"resultId":")" + std::to_string(open->resultId) + '"';
+            if (delta) {
+                result += R"(,"edits":)";
+                open->semanticTokens.writeEdits(result);
+            } else {
+                result += R"(,"data":)";
+                open->semanticTokens.writeAll(result);
+            }
+            result += '}';
+            open->semanticTokens.markSent();
+            respond(*id, result);
+        } else if (id != nullptr) {
+            respondError(*id, METHOD_NOT_FOUND, "Method not found");
+        }
+    }
+
+    /**
+     * @brief Sends a successful response
+     * 
+     * @param[in] id Id of the request
+     * @param[in] result JSON text of the result
+     */
+    void LanguageServer::respond(const JsonValue& id, std::string_view result) {
+        std::string body = R"({"jsonrpc":"2.0","id":)";
+        writeJson(id, body);
+        body += R"(,"result":)";
+        body += result;
+        body += '}';
+        if (writeRpcMessage(out, body) != 0) {
+            writeStatus = -2;
+        }
+    }
+
+    /**
+     * @brief Sends an error response
+     * 
+     * @param[in] id Id of the request
+     * @param[in] code JSON-RPC error code
+     * @param[in] message Description of the error
+     */
+    void LanguageServer::respondError(const JsonValue& id, int code, std::string_view message) {
+        std::string body = R"({"jsonrpc":"2.0","id":)";
+        writeJson(id, body);
+        body += R"(,"error":{"code":)" + std::to_string(code) + R"(,"message":)";
+        writeJsonString(message, body);
+        body += "}}";
+        if (writeRpcMessage(out, body) != 0) {
+            writeStatus = -2;
+        }
+    }
+
+    /**
+     * @brief Finds the open document a request's parameters name
+     * 
+     * @param[in] params Parameters with a `textDocument` member
+     * @return The document, or null if it is not open
+     */
+    LanguageServer::OpenDocument* LanguageServer::findDocument(const JsonValue* params) {
+        const auto found = documents.find(std::string(documentUri(params)));
+        return found != documents.end() ? &found->second : nullptr;
+    }
+
+    /**
+     * @brief Applies the content changes of a change notification
+     * 
+     * Changes before the last whole-text change are skipped. Each ranged
+     * change re-lexes and re-encodes only the tokens it touches, and
+     * updates only the line starts it touches.
+     * 
+     * @param[in, out] open The document to change
+     * @param[in] changes The `contentChanges` array
+     */
+    void LanguageServer::applyChanges(OpenDocument& open, const JsonValue& changes) {
+
+        const auto last = std::find_if(changes.array.rbegin(), changes.array.rend(), replacesAll);
+        const std::size_t first = last == changes.array.rend() ? 0 : changes.array.rend() - last - 1;
+        for (std::size_t i = first; i < changes.array.size(); ++i) {
+            const JsonValue& change = changes.array[i];
+            const JsonValue* range = change.find("range");
+            if (range == nullptr) {
+                open.document.open(std::string(change.stringAt("text")));
+                open.semanticTokens.rebuild(open.document, encoding);
+                open.lines.reset(open.document.text());
+            } else {
+                std::size_t start;
+                std::size_t end;
+                if (!offsetAt(open, range->find("start"), start) || !offsetAt(open, range->find("end"), end)) {
+                    std::cerr << "Error: Ignoring a change with an invalid range.\n";
+                    continue;
+                }
+                if (end < start) {
+                    std::swap(start, end);
+                }
+                const std::size_t oldSize = open.document.text().size();
+                const std::string_view replacement = change.stringAt("text");
+                TokenChange tokenChange;
+                if (open.document.edit(start, end - start, replacement, tokenChange) == 0) {
+                    open.semanticTokens.update(open.document, encoding, tokenChange, oldSize);
+                    open.lines.edit(open.document.text(), start, end - start, replacement.size());
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Converts a client position to a byte offset
+     * 
+     * Positions past the end of a line or of the text are clamped.
+     * 
+     * @param[in] open The document
+     * @param[in] position Position object with `line` and `character`
+     * @param[out] offset The byte offset
+     * @return Whether `position` is a valid position object
+     */
+    bool LanguageServer::offsetAt(const OpenDocument& open, const JsonValue* position, std::size_t& offset) const {
+
+        std::size_t line;
+        std::size_t character;
+        if (position == nullptr || !position->unsignedAt("line", line) || !position->unsignedAt("character", character)) {
+            return false;
+        }
+        const std::string_view text = open.document.text();
+        if (line >= open.lines.lineCount()) {
+            offset = text.size();
+            return true;
+        }
+        const std::string_view lineText = open.lines.lineText(line + 1);
+        std::size_t units = 0;
+        std::size_t i = 0;
+        for (; i < lineText.size(); ++i) {
+            const std::size_t width = columnUnits(lineText[i], encoding);
+            if (width != 0 && units >= character) {
+                break;
+            }
+            units += width;
+        }
+        offset = static_cast<std::size_t>(lineText.data() - text.data()) + i;
+
+        return true;
+    }
+
+}
@@ -0,0 +1,256 @@
+/**
+ * @file language_server.hpp
+ * 
+ * @brief Include file for the language server that keeps open documents
+ *        lexed in memory
+ */
+
+#ifndef LANGUAGE_SERVER_HPP
+#define LANGUAGE_SERVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "document.hpp"
+#include "json_rpc.hpp"
+#include "source_map.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief How the columns of positions exchanged with the client are
+     *        counted
+     */
+    enum class PositionEncoding : std::uint8_t {
+        Utf16,
+        Utf8,
+    };
+
+    /**
+     * @brief A document's semantic tokens in the relative encoding of LSP,
+     *        patched in place as the document is edited
+     * 
+     * Entries live in a gap buffer like the document's tokens, with the
+     * entries after the gap storing their offset counted back from the end
+     * of the text. Since every entry is encoded relative to the one before
+     * it, an edit re-encodes only the entries of the tokens it re-lexed and
+     * the one entry after them. The run of entries changed since the
+     * tokens were last sent is tracked, so a delta is sent without
+     * comparing the old and new tokens.
+     */
+    class SemanticTokenCache {
+    public:
+        struct Entry {
+            std::size_t offset;
+            std::uint32_t deltaLine;
+            std::uint32_t deltaStart;
+            std::uint32_t length;
+            std::uint32_t type;
+        };
+    private:
+        std::vector<Entry> storage;
+        std::size_t gapBegin = 0;
+        std::size_t gapEnd = 0;
+
+        // Entries before `changedBegin` and the last `unchangedSuffix`
+        // entries are as they were last sent
+        bool changed = true;
+        std::size_t changedBegin = 0;
+        std::size_t unchangedSuffix = 0;
+        std::size_t sentSize = 0;
+
+        /**
+         * @brief Moves the gap so that it sits before the first entry at or
+         *        after a byte offset
+         * 
+         * @param[in] offset Byte offset before the edit
+         * @param[in] textSize Size of the text before the edit
+         */
+        void moveGap(std::size_t offset, std::size_t textSize);
+
+        /**
+         * @brief Makes room for at least `count` entries in the gap
+         * 
+         * @param[in] count Number of entries to fit
+         */
+        void reserveGap(std::size_t count);
+
+        /**
+         * @brief Notes that entries from `begin` up to the last `suffix`
+         *        entries no longer match what was sent
+         */
+        void markChanged(std::size_t begin, std::size_t suffix);
+    public:
+        /**
+         * @brief Encodes every token of a document from scratch
+         * 
+         * @param[in] document The document
+         * @param[in] encoding How columns are counted
+         */
+        void rebuild(const Document& document, PositionEncoding encoding);
+
+        /**
+         * @brief Re-encodes the entries of the tokens an edit replaced
+         * 
+         * @param[in] document The document, after the edit
+         * @param[in] encoding How columns are counted
+         * @param[in] change The token range the edit replaced
+         * @param[in] oldSize Size of the text before the edit
+         */
+        void update(const Document& document, PositionEncoding encoding, const TokenChange& change, std::size_t oldSize);
+
+        /**
+         * @brief Provides the number of entries
+         */
+        std::size_t size() const { return storage.size() - (gapEnd - gapBegin); }
+
+        /**
+         * @brief Provides whether the entries changed since they were last sent
+         */
+        bool changedSinceSent() const { return changed; }
+
+        /**
+         * @brief Appends every entry as a JSON array of numbers
+         * 
+         * @param[in, out] out The text to append to
+         */
+        void writeAll(std::string& out) const;
+
+        /**
+         * @brief Appends the edits turning the entries last sent into the
+         *        current ones as a JSON array
+         * 
+         * @param[in, out] out The text to append to
+         */
+        void writeEdits(std::string& out) const;
+
+        /**
+         * @brief Records the current entries as sent
+         */
+        void markSent();
+    };
+
+    /**
+     * @brief Serves a Language Server Protocol client over JSON-RPC
+     * 
+     * Every open document is kept as a `Document` together with its
+     * semantic tokens, so a change only re-lexes and re-encodes the tokens
+     * it touches and requests are answered from memory. Messages that have
+     * already arrived are read as one batch, and a change that replaces a
+     * document's whole text makes earlier changes to it in the same batch
+     * moot, so those are skipped.
+     * 
+     * Supported are `initialize`, `shutdown`, `exit`, document open,
+     * change and close, and full, delta and range semantic token requests.
+     */
+    class LanguageServer {
+    private:
+        struct OpenDocument {
+            Document document;
+            SourceMap lines;
+            std::int64_t version = 0;
+            SemanticTokenCache semanticTokens;
+            std::size_t resultId = 0; // Id of the semantic tokens last sent
+        };
+
+        std::ostream& out;
+        std::unordered_map<std::string, OpenDocument> documents;
+        PositionEncoding encoding = PositionEncoding::Utf16;
+        std::size_t nextResultId = 1;
+        bool initialized = false;
+        bool shutdownRequested = false;
+        bool exitRequested = false;
+        int writeStatus = 0;
+
+        /**
+         * @brief Handles one request or notification
+         * 
+         * @param[in] message The parsed message
+         * @param[in] skipChange Whether a change notification in it is
+         *            superseded and need not be applied
+         */
+        void handle(const JsonValue& message, bool skipChange);
+
+        /**
+         * @brief Sends a successful response
+         * 
+         * @param[in] id Id of the request
+         * @param[in] result JSON text of the result
+         */
+        void respond(const JsonValue& id, std::string_view result);
+
+        /**
+         * @brief Sends an error response
+         * 
+         * @param[in] id Id of the request
+         * @param[in] code JSON-RPC error code
+         * @param[in] message Description of the error
+         */
+        void respondError(const JsonValue& id, int code, std::string_view message);
+
+        /**
+         * @brief Finds the open document a request's parameters name
+         * 
+         * @param[in] params Parameters with a `textDocument` member
+         * @return The document, or null if it is not open
+         */
+        OpenDocument* findDocument(const JsonValue* params);
+
+        /**
+         * @brief Applies the content changes of a change notification
+         * 
+         * @param[in, out] open The document to change
+         * @param[in] changes The `contentChanges` array
+         */
+        void applyChanges(OpenDocument& open, const JsonValue& changes);
+
+        /**
+         * @brief Converts a client position to a byte offset
+         * 
+         * Positions past the end of a line or of the text are clamped.
+         * 
+         * @param[in] open The document
+         * @param[in] position Position object with `line` and `character`
+         * @param[out] offset The byte offset
+         * @return Whether `position` is a valid position object
+         */
+        bool offsetAt(const OpenDocument& open, const JsonValue* position, std::size_t& offset) const;
+    public:
+        /**
+         * @brief Constructor
+         * 
+         * @param[in, out] out Stream responses are written to
+         */
+        explicit LanguageServer(std::ostream& out) : out(out) {}
+
+        /**
+         * @brief Serves messages read from a stream until the client exits
+         *        or the stream ends
+         * 
+         * @param[in, out] in Stream messages are read from
+         * @return Status code
+         * @retval 0 The client sent `shutdown` and then `exit`
+         * @retval 1 The client exited without `shutdown` or the stream ended
+         * @retval -2 Read or write error
+         */
+        int run(std::istream& in);
+
+        /**
+         * @brief Handles a batch of message bodies in order
+         * 
+         * @param[in] bodies The JSON text of each message
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Write Error
+         */
+        int handleBatch(const std::vector<std::string>& bodies);
+    };
+
+}
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file language_spec.hpp
+ * 
+ * @brief Include file for the table of the language's fixed spellings
+ */
+
+#ifndef LANGUAGE_SPEC_HPP
+#define LANGUAGE_SPEC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Allow string_view literals
+using namespace std::literals::string_view_literals;
+
+namespace imperium_lang {
+
+    /**
+     * @brief Dense identifiers of the reserved words
+     */
+    enum class Keyword : std::uint8_t {
+        None,
+        /* Control Flow */
+        If, Else, While, For, Return, Do,
+        /* ADTs */
+        Class, Function, Enum, Signal, RegexT,
+        /* Access Modifiers */
+        Public, Private, Protected,
+        /* Primitive Types */
+        Int, String, Bool, Char, Float, Array, Bits,
+        /* Type Modifiers */
+        Const, Static, Ptr, Ref, Final,
+        /* Compilation Unit Control */
+        Import, Export, Library, Module,
+        /* Semantic keywords */
+        CallbackT, ContinuationT, Template,
+    };
+
+    /**
+     * @brief Dense identifiers of the operators
+     */
+    enum class OperatorKind : std::uint8_t {
+        None,
+        /* Arithmetic */
+        Add, Subtract, Multiply, Divide, Modulo,
+        /* Comparison */
+        Less, Greater, LessEqual, GreaterEqual, Equal, NotEqual,
+        /* Boolean */
+        Not, LogicalAnd, LogicalOr,
+        /* Bitwise */
+        BitAnd, BitOr, BitXor, BitNot, ShiftLeft, ShiftRight,
+        /* Assignment */
+        Assign, AddAssign, SubtractAssign, MultiplyAssign, DivideAssign, ModuloAssign,
+        /* Misc */
+        Scope, Arrow,
+    };
+
+    /**
+     * @brief What a fixed spelling of the language is
+     */
+    enum class SpellingKind : std::uint8_t {
+        Keyword,
+        Operator,
+        Delimiter,
+    };
+
+    /**
+     * @brief One fixed spelling of the language
+     */
+    struct Spelling {
+        std::string_view text;
+        SpellingKind kind;
+        Keyword keyword = Keyword::None; // Set for keywords
+        OperatorKind op = OperatorKind::None; // Set for operators
+
+        constexpr Spelling() : kind(SpellingKind::Delimiter) {}
+        constexpr Spelling(std::string_view text, Keyword keyword) : text(text), kind(SpellingKind::Keyword), keyword(keyword) {}
+        constexpr Spelling(std::string_view text, OperatorKind op) : text(text), kind(SpellingKind::Operator), op(op) {}
+        constexpr Spelling(std::string_view text) : text(text), kind(SpellingKind::Delimiter) {}
+    };
+
+    /* The language spec. Reserved words, operators and delimiters are all derived from this table. */
+
+    constexpr Spelling LANGUAGE_SPEC[] = {
+        /* Control Flow */
+        {"if"sv, Keyword::If}, {"else"sv, Keyword::Else}, {"while"sv, Keyword::While},
+        {"for"sv, Keyword::For}, {"return"sv, Keyword::Return}, {"do"sv, Keyword::Do},
+        /* ADTs */
+        {"class"sv, Keyword::Class}, {"function"sv, Keyword::Function}, {"enum"sv, Keyword::Enum},
+        {"signal"sv, Keyword::Signal}, {"regex_t"sv, Keyword::RegexT},
+        /* Access Modifiers */
+        {"public"sv, Keyword::Public}, {"private"sv, Keyword::Private}, {"protected"sv, Keyword::Protected},
+        /* Primitive Types */
+        {"int"sv, Keyword::Int}, {"string"sv, Keyword::String}, {"bool"sv, Keyword::Bool},
+        {"char"sv, Keyword::Char}, {"float"sv, Keyword::Float}, {"array"sv, Keyword::Array},
+        {"bits"sv, Keyword::Bits},
+        /* Type Modifiers */
+        {"const"sv, Keyword::Const}, {"static"sv, Keyword::Static}, {"ptr"sv, Keyword::Ptr},
+        {"ref"sv, Keyword::Ref}, {"final"sv, Keyword::Final},
+        /* Compilation Unit Control */
+        {"import"sv, Keyword::Import}, {"export"sv, Keyword::Export}, {"library"sv, Keyword::Library},
+        {"module"sv, Keyword::Module},
+        /* Semantic keywords */
+        {"callback_t"sv, Keyword::CallbackT}, {"continuation_t"sv, Keyword::ContinuationT},
+        {"template"sv, Keyword::Template},
+
+        /* Arithmetic */
+        {"+"sv, OperatorKind::Add}, {"-"sv, OperatorKind::Subtract}, {"*"sv, OperatorKind::Multiply},
+        {"/"sv, OperatorKind::Divide}, {"%"sv, OperatorKind::Modulo},
+        /* Comparison */
+        {"<"sv, OperatorKind::Less}, {">"sv, OperatorKind::Greater}, {"<="sv, OperatorKind::LessEqual},
+        {">="sv, OperatorKind::GreaterEqual}, {"=="sv, OperatorKind::Equal}, {"!="sv, OperatorKind::NotEqual},
+        /* Boolean */
+        {"!"sv, OperatorKind::Not}, {"&&"sv, OperatorKind::LogicalAnd}, {"||"sv, OperatorKind::LogicalOr},
+        /* Bitwise */
+        {"&"sv, OperatorKind::BitAnd}, {"|"sv, OperatorKind::BitOr}, {"^"sv, OperatorKind::BitXor},
+        {"~"sv, OperatorKind::BitNot}, {"<<"sv, OperatorKind::ShiftLeft}, {">>"sv, OperatorKind::ShiftRight},
+        /* Assignment */
+        {"="sv, OperatorKind::Assign}, {"+="sv, OperatorKind::AddAssign}, {"-="sv, OperatorKind::SubtractAssign},
+        {"*="sv, OperatorKind::MultiplyAssign}, {"/="sv, OperatorKind::DivideAssign}, {"%="sv, OperatorKind::ModuloAssign},
+        /* Misc */
+        {"::"sv, OperatorKind::Scope}, {"=>"sv, OperatorKind::Arrow},
+
+        /* Delimiters */
+        {";"sv}, {","sv}, {"."sv}, {"("sv}, {")"sv}, {"{"sv}, {"}"sv}, {"["sv}, {"]"sv},
+        {":"sv}, {"\""sv}, {"'"sv},
+    };
+
+    namespace detail {
+        /**
+         * @brief Counts the spellings of one kind
+         */
+        constexpr std::size_t countSpellings(SpellingKind kind) {
+            std::size_t count = 0;
+            for (const auto& spelling : LANGUAGE_SPEC)
+                count += spelling.kind == kind;
+            return count;
+        }
+
+        /**
+         * @brief Collects the spellings of one kind, in table order
+         */
+        template <SpellingKind Kind>
+        constexpr auto collectSpellings() {
+            std::array<Spelling, countSpellings(Kind)> spellings{};
+            std::size_t count = 0;
+            for (const auto& spelling : LANGUAGE_SPEC)
+                if (spelling.kind == Kind)
+                    spellings[count++] = spelling;
+            return spellings;
+        }
+
+        /**
+         * @brief Whether a byte appears in any operator or delimiter
+         */
+        constexpr bool isPunctuationByte(char c) {
+            for (const auto& spelling : LANGUAGE_SPEC)
+                if (spelling.kind != SpellingKind::Keyword && spelling.text.find(c) != std::string_view::npos)
+                    return true;
+            return false;
+        }
+
+        /**
+         * @brief Collects every byte that appears in an operator or delimiter
+         */
+        constexpr auto collectPunctuationBytes() {
+            std::array<char, 128> bytes{};
+            std::size_t count = 0;
+            for (int c = 1; c < 128; ++c)
+                if (isPunctuationByte(static_cast<char>(c)))
+                    bytes[count++] = static_cast<char>(c);
+            return std::pair{bytes, count};
+        }
+    }
+
+    constexpr auto RESERVED_WORDS = detail::collectSpellings<SpellingKind::Keyword>();
+    constexpr auto OPERATORS = detail::collectSpellings<SpellingKind::Operator>();
+    constexpr auto DELIMITERS = detail::collectSpellings<SpellingKind::Delimiter>();
+
+    // Operators and delimiters together, as matched by `matchPunctuation`
+    constexpr auto PUNCTUATION = [] {
+        std::array<Spelling, OPERATORS.size() + DELIMITERS.size()> spellings{};
+        std::size_t count = 0;
+        for (const auto& spelling : OPERATORS)
+            spellings[count++] = spelling;
+        for (const auto& spelling : DELIMITERS)
+            spellings[count++] = spelling;
+        return spellings;
+    }();
+
+    // Every byte that can appear in an operator or a delimiter. None of
+    // these are word characters.
+    constexpr auto PUNCTUATION_BYTES = detail::collectPunctuationBytes();
+    constexpr std::string_view PUNCTUATION_CHARACTER{PUNCTUATION_BYTES.first.data(), PUNCTUATION_BYTES.second};
+
+    // Every delimiter byte
+    constexpr auto DELIMITER_ARRAY = [] {
+        std::array<char, DELIMITERS.size()> bytes{};
+        for (std::size_t i = 0; i < DELIMITERS.size(); ++i)
+            bytes[i] = DELIMITERS[i].text.front();
+        return bytes;
+    }();
+    constexpr std::string_view DELIMITER{DELIMITER_ARRAY.data(), DELIMITER_ARRAY.size()};
+
+    namespace detail {
+        /**
+         * @brief Checks the shape of the table that the lexer relies on
+         * 
+         * Delimiters are single bytes. Every operator and delimiter is
+         * either one byte long or extends a shorter one, so maximal munch
+         * always finds a match once the first byte is punctuation.
+         */
+        constexpr bool languageSpecIsWellFormed() {
+            for (const auto& spelling : DELIMITERS)
+                if (spelling.text.size() != 1)
+                    return false;
+            for (const auto& spelling : PUNCTUATION) {
+                bool prefixFound = spelling.text.size() == 1;
+                for (const auto& shorter : PUNCTUATION)
+                    prefixFound = prefixFound || shorter.text == spelling.text.substr(0, spelling.text.size() - 1);
+                if (!prefixFound)
+                    return false;
+            }
+            for (const auto& spelling : RESERVED_WORDS)
+                for (char c : spelling.text)
+                    if (isPunctuationByte(c))
+                        return false;
+            return true;
+        }
+    }
+    static_assert(detail::languageSpecIsWellFormed(), "The language spec breaks an assumption of the lexer");
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file lexer_dfa.cpp
+ * 
+ * @brief Implementation file for the compile time generated lexer DFA
+ */
+
+#include "lexer_dfa.hpp"
+#include "char_scan.hpp"
+#include <algorithm>
+
+namespace imperium_lang {
+
+    /**
+     * @brief Finds the longest token at the start of `text`
+     * 
+     * Each byte is examined once, either by a table step or by a bulk
+     * scanning kernel for states that loop on themselves. Operators and
+     * delimiters are then extended by maximal munch over the language spec.
+     * 
+     * @param[in] text The text to match. Must not be empty.
+     * @return The matched token. `Invalid` with length 0 if no token matches.
+     */
+    TokenMatch matchToken(std::string_view text) {
+        TokenMatchState resume{};
+        return matchToken(text, resume);
+    }
+
+    /**
+     * @brief Finds the longest token at the start of `text`, continuing an
+     *        earlier match of the same token on a prefix of `text`
+     * 
+     * The DFA only stops early at the end of the text or where it dies, and
+     * a dead state dies again on the same byte, so continuing always gives
+     * the match a single pass over `text` would.
+     * 
+     * @param[in] text The text to match. Must not be empty.
+     * @param[in, out] resume Where the earlier match stopped, or a default
+     *                 state to start afresh. Left where this match stopped.
+     * @return The matched token. `Invalid` with length 0 if no token matches.
+     */
+    TokenMatch matchToken(std::string_view text, TokenMatchState& resume) {
+
+        TokenMatch match = resume.longest;
+        LexerState state = resume.state;
+        std::size_t i = resume.scanned;
+        while (i < text.size()) {
+            const LexerState next = LEXER_TABLES.next[state][static_cast<unsigned char>(text[i])];
+            if (next == Dead) {
+                break;
+            }
+            state = next;
+            ++i;
+            switch (LEXER_TABLES.run[state]) {
+                case LexerRun::None:
+                    break;
+                case LexerRun::Whitespace:
+                    i += scanWhitespace(text.substr(i));
+                    break;
+                case LexerRun::Digits:
+                    i += scanDigits(text.substr(i));
+                    break;
+                case LexerRun::Word:
+                    i += scanWord(text.substr(i));
+                    break;
+                case LexerRun::UntilNewline:
+                    i = std::min(text.find('\n', i), text.size());
+                    break;
+                case LexerRun::UntilStar:
+                    i = std::min(text.find('*', i), text.size());
+                    break;
+            }
+
+            // Remember the longest accepted prefix in case the DFA dies later
+            if (LEXER_TABLES.accept[state] != Invalid) {
+                match = TokenMatch{LEXER_TABLES.accept[state], i};
+            }
+        }
+        resume = TokenMatchState{state, i, match};
+        if (match.type == OperatorSequence) {
+            const Spelling spelling = matchPunctuation(text);
+            match = TokenMatch{spelling.kind == SpellingKind::Operator ? OperatorSequence : Delimiter, spelling.text.size(), spelling.op};
+        }
+
+        return match;
+    }
+
+}
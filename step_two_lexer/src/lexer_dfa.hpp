@@ -0,0 +1,374 @@
+/**
+ * @file lexer_dfa.hpp
+ * 
+ * @brief Include file for the compile time generated lexer DFA
+ */
+
+#ifndef LEXER_DFA_HPP
+#define LEXER_DFA_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "char_class.hpp"
+#include "reserved_words.hpp"
+#include "tokenizer.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief States of the lexer DFA
+     * 
+     * `Start` is the state at every token boundary and `Dead` ends the
+     * current token.
+     */
+    enum LexerState : std::uint8_t {
+        Dead,
+        Start,
+        InWhitespace,
+        AfterPunctuation,
+        InNumber,
+        AfterZero,
+        AfterDigitSeparator,
+        AfterDecimalPoint,
+        InFraction,
+        AfterFractionSeparator,
+        AfterExponentMark,
+        AfterFractionExponentMark,
+        AfterExponentSign,
+        InExponent,
+        AfterHexPrefix,
+        InHexNumber,
+        AfterHexSeparator,
+        AfterBinaryPrefix,
+        InBinaryNumber,
+        AfterBinarySeparator,
+        InWord,
+        AfterSlash,
+        InLineComment,
+        InBlockComment,
+        InBlockCommentStar,
+        AfterBlockComment,
+        LexerStateCount,
+    };
+
+    /**
+     * @brief Bulk scanning kernel a state can use to consume its own
+     *        self-loop without stepping through the table byte by byte
+     */
+    enum class LexerRun : std::uint8_t {
+        None,
+        Whitespace,
+        Digits,
+        Word,
+        UntilNewline,
+        UntilStar,
+    };
+
+    /**
+     * @brief A set of bytes moving the DFA from one state to another
+     * 
+     * Rules are applied in order, so a later rule overrides the bytes it
+     * shares with an earlier rule for the same state. An empty byte set
+     * stands for every byte.
+     */
+    struct LexerTransition {
+        LexerState from;
+        std::string_view bytes;
+        LexerState to;
+    };
+
+    /**
+     * @brief What a state means once the DFA stops in it
+     */
+    struct LexerAccept {
+        LexerState state;
+        TokenType type;
+        LexerRun run;
+    };
+
+    constexpr std::string_view ANY_BYTE = ""sv;
+
+    /* The token specification. Everything the lexer recognizes is derived from these two tables. */
+
+    constexpr LexerTransition LEXER_TRANSITIONS[] = {
+        {Start, WHITESPACE, InWhitespace},
+        {InWhitespace, WHITESPACE, InWhitespace},
+
+        // Operators and delimiters stop the DFA after their first byte;
+        // `matchToken` extends them to the longest spelling that matches
+        {Start, PUNCTUATION_CHARACTER, AfterPunctuation},
+
+        {Start, WORD_CHARACTER, InWord},
+        {Start, UTF8_SEQUENCE_BYTE, InWord},
+        {InWord, WORD_CHARACTER, InWord},
+        {InWord, UTF8_SEQUENCE_BYTE, InWord},
+
+        // Digit runs are numbers unless a word character follows them.
+        // Single `_` separators may sit between digits.
+        {Start, DIGIT, InNumber},
+        {InNumber, WORD_CHARACTER, InWord},
+        {InNumber, UTF8_SEQUENCE_BYTE, InWord},
+        {InNumber, DIGIT, InNumber},
+        {InNumber, "_", AfterDigitSeparator},
+        {InNumber, ".", AfterDecimalPoint},
+        {InNumber, "eE", AfterExponentMark},
+        {AfterDigitSeparator, WORD_CHARACTER, InWord},
+        {AfterDigitSeparator, UTF8_SEQUENCE_BYTE, InWord},
+        {AfterDigitSeparator, DIGIT, InNumber},
+
+        // A leading zero may start a hex or binary literal instead
+        {Start, "0", AfterZero},
+        {AfterZero, WORD_CHARACTER, InWord},
+        {AfterZero, UTF8_SEQUENCE_BYTE, InWord},
+        {AfterZero, DIGIT, InNumber},
+        {AfterZero, "_", AfterDigitSeparator},
+        {AfterZero, ".", AfterDecimalPoint},
+        {AfterZero, "eE", AfterExponentMark},
+        {AfterZero, "xX", AfterHexPrefix},
+        {AfterZero, "bB", AfterBinaryPrefix},
+
+        // A word character after a fraction or an exponent makes the
+        // whole run a word, as it does after an integer
+        {AfterDecimalPoint, DIGIT, InFraction},
+        {InFraction, WORD_CHARACTER, InWord},
+        {InFraction, UTF8_SEQUENCE_BYTE, InWord},
+        {InFraction, DIGIT, InFraction},
+        {InFraction, "_", AfterFractionSeparator},
+        {InFraction, "eE", AfterFractionExponentMark},
+        {AfterFractionSeparator, DIGIT, InFraction},
+        {AfterExponentMark, WORD_CHARACTER, InWord},
+        {AfterExponentMark, UTF8_SEQUENCE_BYTE, InWord},
+        {AfterExponentMark, DIGIT, InExponent},
+        {AfterExponentMark, "+-", AfterExponentSign},
+        {AfterFractionExponentMark, DIGIT, InExponent},
+        {AfterFractionExponentMark, "+-", AfterExponentSign},
+        {AfterExponentSign, DIGIT, InExponent},
+        {InExponent, WORD_CHARACTER, InWord},
+        {InExponent, UTF8_SEQUENCE_BYTE, InWord},
+        {InExponent, DIGIT, InExponent},
+
+        // Hex and binary digits, which are word characters themselves
+        {AfterHexPrefix, WORD_CHARACTER, InWord},
+        {AfterHexPrefix, UTF8_SEQUENCE_BYTE, InWord},
+        {AfterHexPrefix, HEX_DIGIT, InHexNumber},
+        {InHexNumber, WORD_CHARACTER, InWord},
+        {InHexNumber, UTF8_SEQUENCE_BYTE, InWord},
+        {InHexNumber, HEX_DIGIT, InHexNumber},
+        {InHexNumber, "_", AfterHexSeparator},
+        {AfterHexSeparator, WORD_CHARACTER, InWord},
+        {AfterHexSeparator, UTF8_SEQUENCE_BYTE, InWord},
+        {AfterHexSeparator, HEX_DIGIT, InHexNumber},
+        {AfterBinaryPrefix, WORD_CHARACTER, InWord},
+        {AfterBinaryPrefix, UTF8_SEQUENCE_BYTE, InWord},
+        {AfterBinaryPrefix, BINARY_DIGIT, InBinaryNumber},
+        {InBinaryNumber, WORD_CHARACTER, InWord},
+        {InBinaryNumber, UTF8_SEQUENCE_BYTE, InWord},
+        {InBinaryNumber, BINARY_DIGIT, InBinaryNumber},
+        {InBinaryNumber, "_", AfterBinarySeparator},
+        {AfterBinarySeparator, WORD_CHARACTER, InWord},
+        {AfterBinarySeparator, UTF8_SEQUENCE_BYTE, InWord},
+        {AfterBinarySeparator, BINARY_DIGIT, InBinaryNumber},
+
+        // Comments only start at a token boundary
+        {Start, "/", AfterSlash},
+        {AfterSlash, "/", InLineComment},
+        {AfterSlash, "*", InBlockComment},
+        {InLineComment, ANY_BYTE, InLineComment},
+        {InLineComment, "\n", Dead},
+        {InBlockComment, ANY_BYTE, InBlockComment},
+        {InBlockComment, "*", InBlockCommentStar},
+        {InBlockCommentStar, ANY_BYTE, InBlockComment},
+        {InBlockCommentStar, "*", InBlockCommentStar},
+        {InBlockCommentStar, "/", AfterBlockComment},
+    };
+
+    constexpr LexerAccept LEXER_ACCEPTS[] = {
+        {InWhitespace, Whitespace, LexerRun::Whitespace},
+        // The matched spelling tells operators and delimiters apart
+        {AfterPunctuation, OperatorSequence, LexerRun::None},
+        {InNumber, Number, LexerRun::Digits},
+        {AfterZero, Number, LexerRun::None},
+        {InFraction, Number, LexerRun::Digits},
+        {InExponent, Number, LexerRun::Digits},
+        {InHexNumber, Number, LexerRun::None},
+        {InBinaryNumber, Number, LexerRun::None},
+        // Prefixes and trailing separators without digits after them are
+        // words, as they always were
+        {AfterDigitSeparator, CharSequence, LexerRun::None},
+        {AfterExponentMark, CharSequence, LexerRun::None},
+        {AfterHexPrefix, CharSequence, LexerRun::None},
+        {AfterHexSeparator, CharSequence, LexerRun::None},
+        {AfterBinaryPrefix, CharSequence, LexerRun::None},
+        {AfterBinarySeparator, CharSequence, LexerRun::None},
+        {InWord, CharSequence, LexerRun::Word},
+        {AfterSlash, OperatorSequence, LexerRun::None},
+        {InLineComment, Comment, LexerRun::UntilNewline},
+        // An unterminated block comment runs to the end of the input
+        {InBlockComment, Comment, LexerRun::UntilStar},
+        {InBlockCommentStar, Comment, LexerRun::None},
+        {AfterBlockComment, Comment, LexerRun::None},
+    };
+
+    /**
+     * @brief The generated DFA tables
+     */
+    struct LexerTables {
+        std::array<std::array<LexerState, 256>, LexerStateCount> next;
+        std::array<TokenType, LexerStateCount> accept;
+        std::array<LexerRun, LexerStateCount> run;
+    };
+
+    namespace detail {
+        /**
+         * @brief Builds the DFA tables from the token specification at compile time
+         */
+        constexpr LexerTables buildLexerTables() {
+            LexerTables tables{};
+            for (auto& row : tables.next)
+                row.fill(Dead);
+            tables.accept.fill(Invalid);
+            tables.run.fill(LexerRun::None);
+            for (const auto& transition : LEXER_TRANSITIONS) {
+                if (transition.bytes.empty()) {
+                    tables.next[transition.from].fill(transition.to);
+                    continue;
+                }
+                for (char c : transition.bytes)
+                    tables.next[transition.from][static_cast<unsigned char>(c)] = transition.to;
+            }
+            for (const auto& accept : LEXER_ACCEPTS) {
+                tables.accept[accept.state] = accept.type;
+                tables.run[accept.state] = accept.run;
+            }
+            return tables;
+        }
+    }
+
+    constexpr LexerTables LEXER_TABLES = detail::buildLexerTables();
+
+    namespace detail {
+        /**
+         * @brief Checks that every bulk scanning kernel only consumes bytes
+         *        the state loops on, so skipping them cannot change the result
+         */
+        constexpr bool lexerRunsAreSelfLoops() {
+            for (std::size_t state = 0; state < LexerStateCount; ++state) {
+                for (int c = 0; c < 256; ++c) {
+                    bool consumed = false;
+                    switch (LEXER_TABLES.run[state]) {
+                        case LexerRun::None: break;
+                        case LexerRun::Whitespace: consumed = isCharClass(static_cast<char>(c), ClassWhitespace); break;
+                        case LexerRun::Digits: consumed = isCharClass(static_cast<char>(c), ClassDigit); break;
+                        case LexerRun::Word: consumed = isCharClass(static_cast<char>(c), ClassWord); break;
+                        case LexerRun::UntilNewline: consumed = c != '\n'; break;
+                        case LexerRun::UntilStar: consumed = c != '*'; break;
+                    }
+                    if (consumed && LEXER_TABLES.next[state][c] != state)
+                        return false;
+                }
+            }
+            return true;
+        }
+    }
+    static_assert(detail::lexerRunsAreSelfLoops(), "A lexer run kernel consumes bytes its state does not loop on");
+
+    namespace detail {
+        /**
+         * @brief Finds the most bytes past the end of a token that lexing it
+         *        can read
+         * 
+         * Past its last accepting state, the DFA reads on through states
+         * that accept nothing until it dies, as in `1.` or `1e+` before a
+         * byte that is no digit. Maximal munch may also read the rest of
+         * the longest operator.
+         * 
+         * @return The distance, or `SIZE_MAX` if states that accept nothing
+         *         form a cycle
+         */
+        constexpr std::size_t computeLexerLookahead() {
+
+            // Most bytes the DFA can read from a state before it dies or
+            // accepts again, counting the byte that ends it
+            std::array<std::size_t, LexerStateCount> reach{};
+            for (std::size_t round = 0; round <= LexerStateCount; ++round) {
+                bool changed = false;
+                for (std::size_t state = Start; state < LexerStateCount; ++state) {
+                    std::size_t most = 1;
+                    for (int c = 0; c < 256; ++c) {
+                        const LexerState next = LEXER_TABLES.next[state][c];
+                        if (next != Dead && LEXER_TABLES.accept[next] == Invalid && reach[next] + 1 > most)
+                            most = reach[next] + 1;
+                    }
+                    changed = changed || most != reach[state];
+                    reach[state] = most;
+                }
+                if (changed)
+                    continue;
+
+                // A token that fails to lex from `Start` is skipped one byte at a time
+                std::size_t lookahead = MAX_PUNCTUATION_LENGTH - 1;
+                if (reach[Start] - 1 > lookahead)
+                    lookahead = reach[Start] - 1;
+                for (std::size_t state = Start; state < LexerStateCount; ++state)
+                    if (LEXER_TABLES.accept[state] != Invalid && reach[state] > lookahead)
+                        lookahead = reach[state];
+                return lookahead;
+            }
+            return SIZE_MAX;
+        }
+    }
+
+    // Most bytes past the end of a token that lexing it reads. An edit or a
+    // buffer end closer than this to a token can change that token.
+    constexpr std::size_t LEXER_LOOKAHEAD = detail::computeLexerLookahead();
+    static_assert(LEXER_LOOKAHEAD != SIZE_MAX, "Lexer states that accept nothing form a cycle");
+
+    /**
+     * @brief Result of running the DFA over the start of a buffer
+     */
+    struct TokenMatch {
+        TokenType type;
+        std::size_t length;
+        OperatorKind op = OperatorKind::None; // Set for `OperatorSequence` matches
+    };
+
+    /**
+     * @brief Where the DFA stopped in the token at the start of a text
+     * 
+     * Matching the same token again on a longer text picks up from here,
+     * so the bytes already read are not read again.
+     */
+    struct TokenMatchState {
+        LexerState state = Start;
+        std::size_t scanned = 0; // Bytes of the text the DFA has read
+        TokenMatch longest{Invalid, 0}; // Longest accepted prefix before maximal munch
+    };
+
+    /**
+     * @brief Finds the longest token at the start of `text`
+     * 
+     * Each byte is examined once, either by a table step or by a bulk
+     * scanning kernel for states that loop on themselves. Operators and
+     * delimiters are then extended by maximal munch over the language spec.
+     * 
+     * @param[in] text The text to match. Must not be empty.
+     * @return The matched token. `Invalid` with length 0 if no token matches.
+     */
+    TokenMatch matchToken(std::string_view text);
+
+    /**
+     * @brief Finds the longest token at the start of `text`, continuing an
+     *        earlier match of the same token on a prefix of `text`
+     * 
+     * @param[in] text The text to match. Must not be empty.
+     * @param[in, out] resume Where the earlier match stopped, or a default
+     *                 state to start afresh. Left where this match stopped.
+     * @return The matched token. `Invalid` with length 0 if no token matches.
+     */
+    TokenMatch matchToken(std::string_view text, TokenMatchState& resume);
+
+}
+
+#endif
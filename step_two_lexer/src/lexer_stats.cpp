@@ -0,0 +1,106 @@
+/**
+ * @file lexer_stats.cpp
+ * 
+ * @brief Implementation file for optional tokenizer statistics counters
+ */
+
+#include "lexer_stats.hpp"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    /**
+     * @brief Counters of every thread, live or exited
+     */
+    struct StatsRegistry {
+        std::mutex mutex;
+        std::vector<imperium_lang::LexerStats*> live;
+        imperium_lang::LexerStats exited;
+    };
+
+    StatsRegistry& registry() {
+        static StatsRegistry instance;
+        return instance;
+    }
+
+    /**
+     * @brief One thread's counters, which join the registry on first use and
+     *        fold into the exited totals when the thread ends
+     */
+    struct ThreadStats {
+        imperium_lang::LexerStats stats;
+
+        ThreadStats() {
+            std::lock_guard lock(registry().mutex);
+            registry().live.push_back(&stats);
+        }
+
+        ~ThreadStats() {
+            std::lock_guard lock(registry().mutex);
+            auto& live = registry().live;
+            live.erase(std::find(live.begin(), live.end(), &stats));
+            registry().exited += stats;
+        }
+    };
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Adds another set of counters to this one
+     * 
+     * @param[in] other The counters to add
+     * @return This set of counters
+     */
+    LexerStats& LexerStats::operator+=(const LexerStats& other) {
+        bytesRead += other.bytesRead;
+        refills += other.refills;
+        bytesMoved += other.bytesMoved;
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            tokens[i] += other.tokens[i];
+        }
+        keywordHits += other.keywordHits;
+        keywordMisses += other.keywordMisses;
+        for (std::size_t i = 0; i < phaseNanoseconds.size(); ++i) {
+            phaseNanoseconds[i] += other.phaseNanoseconds[i];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Provides the calling thread's counters
+     */
+    LexerStats& lexerStats() {
+        thread_local ThreadStats threadStats;
+        return threadStats.stats;
+    }
+
+    /**
+     * @brief Sums the counters of every thread, including threads that have
+     *        exited
+     * 
+     * @return The summed counters
+     */
+    LexerStats collectLexerStats() {
+        std::lock_guard lock(registry().mutex);
+        LexerStats total = registry().exited;
+        for (const auto* stats : registry().live) {
+            total += *stats;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Zeroes the counters of every thread
+     */
+    void resetLexerStats() {
+        std::lock_guard lock(registry().mutex);
+        registry().exited = LexerStats{};
+        for (auto* stats : registry().live) {
+            *stats = LexerStats{};
+        }
+    }
+
+}
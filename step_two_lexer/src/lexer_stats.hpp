@@ -0,0 +1,137 @@
+/**
+ * @file lexer_stats.hpp
+ * 
+ * @brief Include file for optional tokenizer statistics counters
+ */
+
+#ifndef LEXER_STATS_HPP
+#define LEXER_STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "tokenizer.hpp"
+
+// Statistics are compiled in only when the build defines IMPERIUM_LEXER_STATS
+#ifndef IMPERIUM_LEXER_STATS
+#define IMPERIUM_LEXER_STATS 0
+#endif
+
+// Wraps statements that only exist when statistics are compiled in
+#if IMPERIUM_LEXER_STATS
+#define IMPERIUM_STATS(...) __VA_ARGS__
+#else
+#define IMPERIUM_STATS(...)
+#endif
+
+namespace imperium_lang {
+
+    constexpr bool LEXER_STATS_ENABLED = IMPERIUM_LEXER_STATS != 0;
+
+    /**
+     * @brief Phases of the tokenizer pipeline that are timed
+     */
+    enum class StatsPhase {
+        Read,
+        Lex,
+        Stitch,
+        Intern,
+        PhaseCount,
+    };
+
+    /**
+     * @brief Provides the string name of a `StatsPhase`
+     * 
+     * @param[in] phase The `StatsPhase` to get the name of
+     * @return The string name of the `StatsPhase`
+     */
+    constexpr std::string_view statsPhaseToString(StatsPhase phase) {
+        switch (phase) {
+            case StatsPhase::Read: return "read";
+            case StatsPhase::Lex: return "lex";
+            case StatsPhase::Stitch: return "stitch";
+            case StatsPhase::Intern: return "intern";
+            default: return "invalid";
+        }
+    }
+
+    /**
+     * @brief Counters gathered by the tokenizer
+     * 
+     * Phase times are summed over every call, so with several threads
+     * they can add up to more than the elapsed time.
+     */
+    struct LexerStats {
+        std::uint64_t bytesRead = 0;
+        std::uint64_t refills = 0;
+        std::uint64_t bytesMoved = 0;
+        std::array<std::uint64_t, TOKEN_TYPE_COUNT> tokens{};
+        std::uint64_t keywordHits = 0;
+        std::uint64_t keywordMisses = 0;
+        std::array<std::uint64_t, static_cast<std::size_t>(StatsPhase::PhaseCount)> phaseNanoseconds{};
+
+        /**
+         * @brief Counts one emitted token and the keyword lookup behind it
+         * 
+         * @param[in] type The token's type
+         */
+        void countToken(TokenType type) {
+            ++tokens[type];
+            keywordHits += type == ReservedWord;
+            keywordMisses += type == CharSequence;
+        }
+
+        /**
+         * @brief Adds another set of counters to this one
+         * 
+         * @param[in] other The counters to add
+         * @return This set of counters
+         */
+        LexerStats& operator+=(const LexerStats& other);
+    };
+
+    /**
+     * @brief Provides the calling thread's counters
+     */
+    LexerStats& lexerStats();
+
+    /**
+     * @brief Sums the counters of every thread, including threads that have
+     *        exited
+     * 
+     * Must not run while other threads are tokenizing.
+     * 
+     * @return The summed counters
+     */
+    LexerStats collectLexerStats();
+
+    /**
+     * @brief Zeroes the counters of every thread
+     * 
+     * Must not run while other threads are tokenizing.
+     */
+    void resetLexerStats();
+
+    /**
+     * @brief Adds the time until it is destroyed to a phase of the calling
+     *        thread's counters
+     */
+    class PhaseTimer {
+    private:
+        StatsPhase phase;
+        std::chrono::steady_clock::time_point start;
+    public:
+        explicit PhaseTimer(StatsPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+        ~PhaseTimer() {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            lexerStats().phaseNanoseconds[static_cast<std::size_t>(phase)] +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        }
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+    };
+
+}
+
+#endif
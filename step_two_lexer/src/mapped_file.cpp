@@ -0,0 +1,98 @@
+/**
+ * @file mapped_file.cpp
+ * 
+ * @brief Implementation file for read-only memory mapped source files
+ */
+
+#include "mapped_file.hpp"
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IMPERIUM_HAS_MMAP 1
+#endif
+
+namespace imperium_lang {
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    /**
+     * @brief Maps a file into memory, replacing any current mapping
+     * 
+     * @param[in] path The file to map
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 The file is not a regular file and cannot be mapped
+     * @retval -2 Read Error
+     */
+    int MappedFile::open(const std::string& path) {
+
+        close();
+#ifdef IMPERIUM_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return -2;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return -2;
+        }
+        if (!S_ISREG(info.st_mode)) {
+            ::close(fd);
+            return 1;
+        }
+
+        // mmap rejects zero length mappings, so an empty file maps to an empty view
+        if (info.st_size == 0) {
+            ::close(fd);
+            return 0;
+        }
+        void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return -2;
+        }
+        ::madvise(mapping, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+        ::madvise(mapping, static_cast<std::size_t>(info.st_size), MADV_WILLNEED);
+        data = mapping;
+        size = static_cast<std::size_t>(info.st_size);
+
+        return 0;
+#else
+        (void)path;
+        return 1;
+#endif
+    }
+
+    /**
+     * @brief Unmaps the current mapping, if any
+     */
+    void MappedFile::close() {
+#ifdef IMPERIUM_HAS_MMAP
+        if (data != nullptr) {
+            ::munmap(data, size);
+        }
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+}
@@ -0,0 +1,63 @@
+/**
+ * @file mapped_file.hpp
+ * 
+ * @brief Include file for read-only memory mapped source files
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace imperium_lang {
+
+    /**
+     * @brief Read-only memory mapping of a whole source file
+     * 
+     * Only regular files are mapped. Pipes, character devices and other
+     * non-seekable inputs are reported back to the caller so it can fall
+     * back to reading them as a stream.
+     */
+    class MappedFile {
+    private:
+        void* data = nullptr;
+        std::size_t size = 0;
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        /**
+         * @brief Maps a file into memory, replacing any current mapping
+         * 
+         * @param[in] path The file to map
+         * @return Status code
+         * @retval 0 Success
+         * @retval 1 The file is not a regular file and cannot be mapped
+         * @retval -2 Read Error
+         */
+        int open(const std::string& path);
+
+        /**
+         * @brief Unmaps the current mapping, if any
+         */
+        void close();
+
+        /**
+         * @brief Provides the mapped file contents
+         * 
+         * @return View of the whole file. Empty if nothing is mapped.
+         */
+        std::string_view contents() const {
+            return std::string_view(static_cast<const char*>(data), size);
+        }
+    };
+
+}
+
+#endif
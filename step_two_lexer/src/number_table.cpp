@@ -0,0 +1,196 @@
+/**
+ * @file number_table.cpp
+ * 
+ * @brief Implementation file for decoded numeric literals and their side
+ *        table
+ */
+
+#include "number_table.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <string>
+
+namespace {
+    constexpr std::size_t MAX_DECIMAL_DIGITS = 10; // Digits of INT32_MAX
+    constexpr std::size_t DECIMAL_WIDTH = 16;
+    constexpr std::size_t HEX_WIDTH = 16;
+    constexpr std::size_t BINARY_WIDTH = 64;
+    constexpr std::size_t FLOAT_BUFFER_SIZE = 128;
+
+    constexpr std::uint64_t REPEATED_BYTE = 0x0101010101010101u;
+
+    /**
+     * @brief Reads eight bytes as a little endian integer, so the first
+     *        byte lands in the lowest lane
+     */
+    inline std::uint64_t loadEight(const char* chars) {
+        std::uint64_t value;
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(&value, chars, 8);
+        } else {
+            value = 0;
+            for (int i = 7; i >= 0; --i) {
+                value = value << 8 | static_cast<unsigned char>(chars[i]);
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief Parses eight decimal digits within one 64-bit word
+     * 
+     * Neighbouring digits are joined into pairs with one multiply, then
+     * pairs into fours and fours into the result, instead of eight
+     * dependent multiply-adds.
+     */
+    inline std::uint64_t parseEightDigits(const char* chars) {
+        std::uint64_t value = loadEight(chars) - '0' * REPEATED_BYTE;
+        value = (value * 10 + (value >> 8)) & 0x00FF00FF00FF00FFu;
+        value = (value * 100 + (value >> 16)) & 0x0000FFFF0000FFFFu;
+        return (value * 10000 + (value >> 32)) & 0xFFFFFFFFu;
+    }
+
+    /**
+     * @brief Parses eight hex digits within one 64-bit word
+     * 
+     * Letters have bit 6 set and count their low nibble from 1, so every
+     * byte becomes its nibble at once before the nibbles are packed.
+     */
+    inline std::uint64_t parseEightHexDigits(const char* chars) {
+        std::uint64_t value = loadEight(chars);
+        value = (value & 0x0F * REPEATED_BYTE) + (value >> 6 & REPEATED_BYTE) * 9;
+        value = (value << 4 | value >> 8) & 0x00FF00FF00FF00FFu;
+        value = (value << 8 | value >> 16) & 0x0000FFFF0000FFFFu;
+        return (value << 16 | value >> 32) & 0xFFFFFFFFu;
+    }
+
+    /**
+     * @brief Parses eight binary digits within one 64-bit word
+     * 
+     * One multiply moves the low bit of every byte into the top byte, with
+     * the first digit ending up as the most significant bit.
+     */
+    inline std::uint64_t parseEightBinaryDigits(const char* chars) {
+        const std::uint64_t value = loadEight(chars) - '0' * REPEATED_BYTE;
+        return value * 0x8040201008040201u >> 56;
+    }
+
+    /**
+     * @brief Copies the significant digits of a literal right aligned into
+     *        a buffer padded with `0`, leaving out separators and leading
+     *        zeros
+     * 
+     * @param[in] digits The literal's digits and separators
+     * @param[out] padded Buffer of `width` bytes
+     * @param[in] width Size of `padded`
+     * @param[out] count Number of significant digits
+     * @return Whether the significant digits fit
+     */
+    bool alignDigits(std::string_view digits, char* padded, std::size_t width, std::size_t& count) {
+        const std::size_t start = std::min(digits.find_first_not_of("0_"), digits.size());
+        count = 0;
+        for (std::size_t i = start; i < digits.size(); ++i) {
+            count += digits[i] != '_';
+        }
+        if (count > width) {
+            return false;
+        }
+        std::memset(padded, '0', width);
+        char* out = padded + width - count;
+        for (std::size_t i = start; i < digits.size(); ++i) {
+            if (digits[i] != '_') {
+                *out++ = digits[i];
+            }
+        }
+        return true;
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Decodes the text of a `Number` token
+     * 
+     * Integer digits are parsed eight at a time within a 64-bit word.
+     * Decimals with a fraction or an exponent go through `std::from_chars`,
+     * which rounds correctly.
+     * 
+     * @param[in] text The token's text
+     * @return The literal's value
+     */
+    NumberValue decodeNumber(std::string_view text) {
+
+        NumberValue value;
+        std::size_t count;
+        const bool prefixed = text.size() > 2 && text[0] == '0';
+        if (prefixed && (text[1] == 'x' || text[1] == 'X')) {
+            char padded[HEX_WIDTH];
+            if (!alignDigits(text.substr(2), padded, HEX_WIDTH, count)) {
+                value.kind = NumberKind::OutOfRange;
+                return value;
+            }
+            value.kind = NumberKind::Bits;
+            value.bits = parseEightHexDigits(padded) << 32 | parseEightHexDigits(padded + 8);
+        } else if (prefixed && (text[1] == 'b' || text[1] == 'B')) {
+            char padded[BINARY_WIDTH];
+            if (!alignDigits(text.substr(2), padded, BINARY_WIDTH, count)) {
+                value.kind = NumberKind::OutOfRange;
+                return value;
+            }
+            value.kind = NumberKind::Bits;
+            value.bits = 0;
+            for (std::size_t i = 0; i < BINARY_WIDTH; i += 8) {
+                value.bits = value.bits << 8 | parseEightBinaryDigits(padded + i);
+            }
+        } else if (text.find_first_of(".eE") != std::string_view::npos) {
+
+            // `std::from_chars` knows no separators, so drop them first
+            char buffer[FLOAT_BUFFER_SIZE];
+            std::string longText;
+            std::string_view digits = text;
+            if (text.find('_') != std::string_view::npos) {
+                char* out = buffer;
+                if (text.size() > FLOAT_BUFFER_SIZE) {
+                    longText.resize(text.size());
+                    out = longText.data();
+                }
+                const char* begin = out;
+                for (const char c : text) {
+                    if (c != '_') {
+                        *out++ = c;
+                    }
+                }
+                digits = std::string_view(begin, static_cast<std::size_t>(out - begin));
+            }
+            value.real = 0.0;
+            const auto result = std::from_chars(digits.data(), digits.data() + digits.size(), value.real);
+            value.kind = result.ec == std::errc{} ? NumberKind::Float : NumberKind::OutOfRange;
+        } else {
+            char padded[DECIMAL_WIDTH];
+            const std::uint64_t magnitude = alignDigits(text, padded, DECIMAL_WIDTH, count) && count <= MAX_DECIMAL_DIGITS
+                ? parseEightDigits(padded) * 100000000 + parseEightDigits(padded + 8) : UINT64_MAX;
+            if (magnitude > static_cast<std::uint64_t>(INT32_MAX)) {
+                value.kind = NumberKind::OutOfRange;
+                return value;
+            }
+            value.kind = NumberKind::Int;
+            value.integer = static_cast<std::int32_t>(magnitude);
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Decodes a literal and adds its value
+     * 
+     * @param[in] text The text of a `Number` token
+     * @return The id of the value
+     */
+    NumberId NumberTable::add(std::string_view text) {
+        values.push_back(decodeNumber(text));
+        return static_cast<NumberId>(values.size() - 1);
+    }
+
+}
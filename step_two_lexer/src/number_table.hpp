@@ -0,0 +1,95 @@
+/**
+ * @file number_table.hpp
+ * 
+ * @brief Include file for decoded numeric literals and their side table
+ */
+
+#ifndef NUMBER_TABLE_HPP
+#define NUMBER_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace imperium_lang {
+
+    using NumberId = std::uint32_t;
+
+    constexpr NumberId NO_NUMBER = UINT32_MAX;
+
+    /**
+     * @brief What a numeric literal decodes to
+     */
+    enum class NumberKind : std::uint8_t {
+        Int,        // A decimal integer, held in `integer`
+        Float,      // A decimal with a fraction or an exponent, held in `real`
+        Bits,       // A `0x` or `0b` literal, held in `bits`
+        OutOfRange, // The literal does not fit its kind
+    };
+
+    /**
+     * @brief The value of a numeric literal
+     * 
+     * Only the member matching `kind` is set. Decimal integers fit `integer`
+     * when they are at most `INT32_MAX`, hex and binary literals fit
+     * `bits` when they have at most 64 significant bits, and decimals with
+     * a fraction or an exponent are rounded to the nearest `double`.
+     */
+    struct NumberValue {
+        NumberKind kind = NumberKind::Int;
+        union {
+            std::int32_t integer;
+            double real;
+            std::uint64_t bits = 0;
+        };
+    };
+
+    /**
+     * @brief Decodes the text of a `Number` token
+     * 
+     * @param[in] text The token's text
+     * @return The literal's value
+     */
+    NumberValue decodeNumber(std::string_view text);
+
+    /**
+     * @brief The decoded values of the numeric literals of a source, so no
+     *        later stage has to read their text again
+     * 
+     * `Number` tokens refer to their value by a 32-bit id. Ids are dense
+     * and handed out in source order.
+     */
+    class NumberTable {
+    private:
+        std::vector<NumberValue> values;
+    public:
+        /**
+         * @brief Decodes a literal and adds its value
+         * 
+         * @param[in] text The text of a `Number` token
+         * @return The id of the value
+         */
+        NumberId add(std::string_view text);
+
+        /**
+         * @brief Provides the value of a literal
+         * 
+         * @param[in] id The number id
+         */
+        const NumberValue& value(NumberId id) const { return values[id]; }
+
+        /**
+         * @brief Provides the number of values
+         */
+        std::size_t size() const { return values.size(); }
+
+        /**
+         * @brief Forgets every value while keeping the allocated memory
+         */
+        void clear() { values.clear(); }
+    };
+
+}
+
+#endif
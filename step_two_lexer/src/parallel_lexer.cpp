@@ -0,0 +1,214 @@
+/**
+ * @file parallel_lexer.cpp
+ * 
+ * @brief Implementation file for lexing one large source in parallel chunks
+ */
+
+#include "parallel_lexer.hpp"
+#include "lexer_stats.hpp"
+#include "char_scan.hpp"
+#include "source_map.hpp"
+#include <algorithm>
+#include <iostream>
+#include <optional>
+
+namespace {
+
+    /**
+     * @brief Tokens of one chunk lexed from an assumed token boundary
+     */
+    struct Speculation {
+        std::size_t start = std::string_view::npos; // npos if this speculation was not run
+        std::size_t end = 0; // End of the last token, or where lexing failed
+        bool failed = false;
+        std::vector<imperium_lang::TokenView> tokens;
+    };
+
+    struct Chunk {
+        std::size_t begin;
+        std::size_t end;
+        Speculation fromBegin;
+        Speculation afterComment;
+    };
+
+    /**
+     * @brief Lexes from `start` until a token ends at or past `chunkEnd`
+     * 
+     * A speculation that starts inside a long comment or string lexes its
+     * contents as tokens nobody will use, so it gives up after
+     * `MAX_SPECULATIVE_TOKENS` and the stitch lexes the rest of the chunk
+     * serially if it turns out to be needed.
+     * 
+     * @param[in] source The whole source
+     * @param[in] start Offset assumed to be a token boundary
+     * @param[in] chunkEnd Offset to stop at
+     * @param[out] speculation The tokens lexed
+     */
+    void speculate(std::string_view source, std::size_t start, std::size_t chunkEnd, Speculation& speculation) {
+        speculation.start = start;
+        std::size_t pos = start;
+        while (pos < chunkEnd && pos < source.size() && speculation.tokens.size() < imperium_lang::MAX_SPECULATIVE_TOKENS) {
+            imperium_lang::TokenView token;
+            if (!imperium_lang::lexToken(source.substr(pos), token)) {
+                speculation.failed = true;
+                break;
+            }
+            token.offset = pos;
+            speculation.tokens.push_back(token);
+            pos += token.length;
+        }
+        speculation.end = pos;
+    }
+
+    /**
+     * @brief Finds the speculative token starting at `offset`
+     * 
+     * @return Index of the token, or npos if no token starts there
+     */
+    std::size_t findTokenAt(const Speculation& speculation, std::size_t offset) {
+        if (speculation.start == std::string_view::npos) {
+            return std::string_view::npos;
+        }
+        const auto it = std::lower_bound(speculation.tokens.begin(), speculation.tokens.end(), offset,
+            [](const imperium_lang::TokenView& token, std::size_t value) { return token.offset < value; });
+        if (it == speculation.tokens.end() || it->offset != offset) {
+            return std::string_view::npos;
+        }
+        return static_cast<std::size_t>(it - speculation.tokens.begin());
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Tokenize an in-memory source by lexing chunks of it in parallel
+     * 
+     * @param[in] source The source buffer to tokenize. Must outlive `tokens`.
+     * @param[out] tokens The tokens extracted from the source buffer
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in] pool Threads to lex the chunks on
+     * @param[in] chunkSize Bytes per chunk. 0 picks `PARALLEL_CHUNK_SIZE`.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int tokenizeParallel(std::string_view source, std::vector<TokenView>& tokens, SymbolTable* symbols, WorkStealingPool& pool, std::size_t chunkSize,
+        TriviaMode trivia, NumberTable* numbers) {
+
+        if (chunkSize == 0) {
+            chunkSize = PARALLEL_CHUNK_SIZE;
+        }
+        if (pool.size() == 1 || source.size() <= chunkSize) {
+            return Tokenizer::tokenize(source, tokens, symbols, trivia, numbers);
+        }
+        tokens.clear();
+        IMPERIUM_STATS(std::optional<PhaseTimer> timer(std::in_place, StatsPhase::Lex);)
+        const std::size_t invalid = findInvalidUtf8(source);
+        if (invalid != std::string_view::npos) {
+            const auto location = SourceMap(source).locate(invalid);
+            std::cerr << "Parse Error: Invalid UTF-8 at line " << location.line << ", column " << location.column << ".\n";
+            return -1;
+        }
+
+        // Chunks are lexed a window at a time, so only the speculations of
+        // one window are held however large the source is
+        const std::size_t chunkCount = (source.size() + chunkSize - 1) / chunkSize;
+        std::vector<Chunk> window(std::min(chunkCount, pool.size() * CHUNKS_PER_THREAD));
+        std::size_t pos = 0;
+        for (std::size_t windowStart = 0; windowStart < chunkCount; windowStart += window.size()) {
+
+            // Lex every chunk of the window speculatively
+            IMPERIUM_STATS(timer.emplace(StatsPhase::Lex);)
+            const std::size_t windowSize = std::min(window.size(), chunkCount - windowStart);
+            pool.parallelFor(windowSize, [&](std::size_t, std::size_t slot) {
+                const std::size_t index = windowStart + slot;
+                Chunk& chunk = window[slot];
+                chunk.begin = index * chunkSize;
+                chunk.end = std::min(source.size(), chunk.begin + chunkSize);
+                chunk.fromBegin.tokens.clear();
+                chunk.afterComment.tokens.clear();
+                chunk.fromBegin.start = std::string_view::npos;
+                chunk.afterComment.start = std::string_view::npos;
+
+                // The true stream has already passed chunks that a long
+                // token covers, so they need no speculation
+                if (chunk.end <= pos) {
+                    return;
+                }
+                speculate(source, chunk.begin, chunk.end, chunk.fromBegin);
+
+                // A comment close before any comment open suggests the chunk starts inside a comment
+                const std::string_view text = source.substr(chunk.begin, chunk.end - chunk.begin + 1);
+                const std::size_t close = text.find("*/");
+                if (index > 0 && close != std::string_view::npos && close < text.find("/*")) {
+                    speculate(source, chunk.begin + close + 2, chunk.end, chunk.afterComment);
+                }
+            });
+
+            // Stitch the chunks together along the true token boundaries
+            IMPERIUM_STATS(timer.emplace(StatsPhase::Stitch);)
+            for (std::size_t slot = 0; slot < windowSize; ++slot) {
+                const Chunk& chunk = window[slot];
+                while (pos < chunk.end) {
+                    const Speculation* synced = nullptr;
+                    std::size_t first = std::string_view::npos;
+                    for (const Speculation* speculation : {&chunk.fromBegin, &chunk.afterComment}) {
+                        first = findTokenAt(*speculation, pos);
+                        if (first != std::string_view::npos) {
+                            synced = speculation;
+                            break;
+                        }
+                    }
+                    if (synced != nullptr) {
+                        tokens.insert(tokens.end(), synced->tokens.begin() + first, synced->tokens.end());
+                        pos = synced->end;
+                        continue;
+                    }
+
+                    // No speculation starts here yet, so lex serially until one lines up
+                    TokenView token;
+                    if (!lexToken(source.substr(pos), token)) {
+                        const auto location = SourceMap(source).locate(pos);
+                        std::cerr << "Parse Error: Failed to extract token at line " << location.line << ", column " << location.column << ".\n";
+                        return -1;
+                    }
+                    token.offset = pos;
+                    tokens.push_back(token);
+                    pos += token.length;
+                }
+            }
+        }
+
+        // Speculation needs the trivia to find token boundaries, so it is
+        // only dropped once the stream is stitched
+        if (trivia == TriviaMode::Skip) {
+            std::erase_if(tokens, [](const TokenView& token) {
+                return token.type == TokenType::Whitespace || token.type == TokenType::Comment;
+            });
+            tokens.push_back(TokenView{TokenType::EndOfFile, source.size(), 0});
+        }
+
+        // Intern and decode in stream order so ids match a serial run
+        IMPERIUM_STATS(
+            timer.emplace(StatsPhase::Intern);
+            auto& stats = lexerStats();
+            for (const auto& token : tokens) {
+                stats.countToken(token.type);
+            }
+        )
+        if (symbols != nullptr || numbers != nullptr) {
+            for (auto& token : tokens) {
+                if (token.type == TokenType::CharSequence && symbols != nullptr) {
+                    token.symbol = symbols->intern(token.text(source));
+                } else if (token.type == TokenType::Number && numbers != nullptr) {
+                    token.number = numbers->add(token.text(source));
+                }
+            }
+        }
+
+        return 0;
+    }
+
+}
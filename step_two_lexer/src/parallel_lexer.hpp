@@ -0,0 +1,59 @@
+/**
+ * @file parallel_lexer.hpp
+ * 
+ * @brief Include file for lexing one large source in parallel chunks
+ */
+
+#ifndef PARALLEL_LEXER_HPP
+#define PARALLEL_LEXER_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "number_table.hpp"
+#include "symbol_table.hpp"
+#include "thread_pool.hpp"
+#include "tokenizer.hpp"
+
+namespace imperium_lang {
+
+    constexpr std::size_t PARALLEL_CHUNK_SIZE = 1 << 19;
+    constexpr std::size_t CHUNKS_PER_THREAD = 4; // Chunks lexed at once per thread
+    constexpr std::size_t MAX_SPECULATIVE_TOKENS = 1 << 18; // Tokens a speculation lexes before giving up
+
+    /**
+     * @brief Tokenize an in-memory source by lexing chunks of it in parallel
+     * 
+     * Every chunk is lexed speculatively, once from its first byte and, when
+     * the chunk looks like it starts inside a block comment, once more from
+     * just after the first `*` `/`. The chunks are then stitched in order:
+     * the lexer has no state across token boundaries, so as soon as a
+     * speculative token starts where the true stream has reached, the rest
+     * of that speculation is the true stream. Bytes where no speculation
+     * lines up are re-lexed serially.
+     * 
+     * Only `CHUNKS_PER_THREAD` chunks per thread are in flight at a time,
+     * and a speculation gives up after `MAX_SPECULATIVE_TOKENS`, so the
+     * memory speculation takes does not grow with the source. A pool of
+     * one thread, or a source of one chunk, is lexed serially instead.
+     * 
+     * The tokens, symbol ids and number ids are identical to
+     * `Tokenizer::tokenize`.
+     * 
+     * @param[in] source The source buffer to tokenize. Must outlive `tokens`.
+     * @param[out] tokens The tokens extracted from the source buffer
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in] pool Threads to lex the chunks on
+     * @param[in] chunkSize Bytes per chunk. 0 picks `PARALLEL_CHUNK_SIZE`.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int tokenizeParallel(std::string_view source, std::vector<TokenView>& tokens, SymbolTable* symbols, WorkStealingPool& pool, std::size_t chunkSize = 0,
+        TriviaMode trivia = TriviaMode::Keep, NumberTable* numbers = nullptr);
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file reserved_words.hpp
+ * 
+ * @brief Include file for the compile time perfect hashes over the language
+ *        spec's spellings
+ */
+
+#ifndef RESERVED_WORDS_HPP
+#define RESERVED_WORDS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "language_spec.hpp"
+
+// Allow string_view literals
+using namespace std::literals::string_view_literals;
+
+namespace imperium_lang {
+
+    namespace detail {
+        /**
+         * @brief Perfect hash of a spelling built from its length and its
+         *        first and last bytes
+         */
+        template <std::size_t TableSize> // Must be a power of two
+        struct SpellingHash {
+            std::uint32_t lengthFactor;
+            std::uint32_t firstFactor;
+            std::array<std::uint8_t, TableSize> slots; // Index into the spellings plus one, 0 if empty
+
+            constexpr std::size_t operator()(std::string_view text) const {
+                return (static_cast<std::uint32_t>(text.size()) * lengthFactor
+                    + static_cast<unsigned char>(text.front()) * firstFactor
+                    + static_cast<unsigned char>(text.back())) & (TableSize - 1);
+            }
+        };
+
+        /**
+         * @brief Searches for hash factors that place every spelling in its
+         *        own slot
+         */
+        template <std::size_t TableSize, std::size_t Count>
+        constexpr SpellingHash<TableSize> buildSpellingHash(const std::array<Spelling, Count>& spellings) {
+            for (std::uint32_t lengthFactor = 1; lengthFactor < 256; ++lengthFactor) {
+                for (std::uint32_t firstFactor = 1; firstFactor < 256; ++firstFactor) {
+                    SpellingHash<TableSize> hash{lengthFactor, firstFactor, {}};
+                    bool collision = false;
+                    for (std::size_t i = 0; i < Count && !collision; ++i) {
+                        auto& slot = hash.slots[hash(spellings[i].text)];
+                        collision = slot != 0;
+                        slot = static_cast<std::uint8_t>(i + 1);
+                    }
+                    if (!collision)
+                        return hash;
+                }
+            }
+            return SpellingHash<TableSize>{0, 0, {}};
+        }
+
+        template <std::size_t Count>
+        constexpr std::size_t maxSpellingLength(const std::array<Spelling, Count>& spellings) {
+            std::size_t length = 0;
+            for (const auto& spelling : spellings)
+                length = spelling.text.size() > length ? spelling.text.size() : length;
+            return length;
+        }
+
+        /**
+         * @brief Looks up a spelling through its perfect hash
+         * 
+         * @return Index of the spelling plus one, or 0 if `text` is not one
+         */
+        template <std::size_t TableSize, std::size_t Count>
+        constexpr std::size_t findSpelling(const SpellingHash<TableSize>& hash, const std::array<Spelling, Count>& spellings,
+                std::string_view text) {
+            const std::uint8_t slot = hash.slots[hash(text)];
+            return slot != 0 && spellings[slot - 1].text == text ? slot : 0;
+        }
+    }
+
+    constexpr auto KEYWORD_HASH = detail::buildSpellingHash<128>(RESERVED_WORDS);
+    static_assert(KEYWORD_HASH.lengthFactor != 0, "No perfect hash found for the reserved words; grow its table");
+    constexpr auto PUNCTUATION_HASH = detail::buildSpellingHash<128>(PUNCTUATION);
+    static_assert(PUNCTUATION_HASH.lengthFactor != 0, "No perfect hash found for the operators and delimiters; grow its table");
+    constexpr std::size_t MAX_PUNCTUATION_LENGTH = detail::maxSpellingLength(PUNCTUATION);
+
+    /**
+     * @brief Looks up the keyword a character sequence spells
+     * 
+     * @param[in] charSequence The character sequence to look up
+     * @return The keyword
+     * @retval Keyword::None The character sequence is not a reserved word
+     */
+    constexpr Keyword lookupKeyword(std::string_view charSequence) {
+        if (charSequence.empty() || charSequence.size() > detail::maxSpellingLength(RESERVED_WORDS))
+            return Keyword::None;
+        const std::size_t found = detail::findSpelling(KEYWORD_HASH, RESERVED_WORDS, charSequence);
+        return found == 0 ? Keyword::None : RESERVED_WORDS[found - 1].keyword;
+    }
+
+    /**
+     * @brief Checks if a given character sequence is a reserved word
+     * 
+     * @param[in] charSequence The character sequence to check
+     */
+    constexpr bool isReservedWord(std::string_view charSequence) {
+        return lookupKeyword(charSequence) != Keyword::None;
+    }
+
+    /**
+     * @brief Finds the longest operator or delimiter at the start of `text`
+     * 
+     * Longer spellings are tried first, one perfect hash probe each.
+     * 
+     * @param[in] text The text to match
+     * @return The matched spelling, or one with empty text if `text` does
+     *         not start with an operator or delimiter
+     */
+    constexpr Spelling matchPunctuation(std::string_view text) {
+        for (std::size_t length = text.size() < MAX_PUNCTUATION_LENGTH ? text.size() : MAX_PUNCTUATION_LENGTH; length > 0; --length) {
+            const std::size_t found = detail::findSpelling(PUNCTUATION_HASH, PUNCTUATION, text.substr(0, length));
+            if (found != 0)
+                return PUNCTUATION[found - 1];
+        }
+        return Spelling{};
+    }
+
+    /**
+     * @brief Looks up the operator a token spells
+     * 
+     * @param[in] text The token's text
+     * @return The operator
+     * @retval OperatorKind::None The text is not exactly an operator
+     */
+    constexpr OperatorKind lookupOperator(std::string_view text) {
+        if (text.empty() || text.size() > MAX_PUNCTUATION_LENGTH)
+            return OperatorKind::None;
+        const std::size_t found = detail::findSpelling(PUNCTUATION_HASH, PUNCTUATION, text);
+        return found == 0 ? OperatorKind::None : PUNCTUATION[found - 1].op;
+    }
+
+    static_assert(lookupKeyword("continuation_t"sv) == Keyword::ContinuationT);
+    static_assert(matchPunctuation("<=>"sv).op == OperatorKind::LessEqual);
+    static_assert(matchPunctuation("::"sv).op == OperatorKind::Scope);
+    static_assert(matchPunctuation(":a"sv).kind == SpellingKind::Delimiter);
+    static_assert(lookupOperator(">>"sv) == OperatorKind::ShiftRight);
+    static_assert(!isReservedWord("integer"sv));
+}
+
+#endif
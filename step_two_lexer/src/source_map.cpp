@@ -0,0 +1,136 @@
+/**
+ * @file source_map.cpp
+ * 
+ * @brief Implementation file for mapping source offsets to lines and columns
+ */
+
+#include "source_map.hpp"
+#include "char_scan.hpp"
+#include <algorithm>
+
+namespace {
+
+    /**
+     * @brief Counts the UTF-8 code points in `text` by counting every byte
+     *        that is not a continuation byte
+     * 
+     * @param[in] text The text to count
+     */
+    std::size_t countCodePoints(std::string_view text) {
+        std::size_t count = 0;
+        for (const char c : text)
+            count += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        return count;
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Builds the line start table if it has not been yet
+     */
+    void SourceMap::build() const {
+
+        if (built) {
+            return;
+        }
+        lineStarts.clear();
+        lineStarts.push_back(0);
+        findNewlines(text, lineStarts);
+
+        // Turn each newline offset into the start of the line after it
+        for (std::size_t i = 1; i < lineStarts.size(); ++i) {
+            ++lineStarts[i];
+        }
+        built = true;
+    }
+
+    /**
+     * @brief Points the map at another source buffer, dropping any table
+     * 
+     * @param[in] text The source buffer. Must outlive the map.
+     */
+    void SourceMap::reset(std::string_view text) {
+        this->text = text;
+        built = false;
+    }
+
+    /**
+     * @brief Follows an edit of the source buffer, updating the table
+     *        for the edited range only
+     * 
+     * Lines starting inside the replaced range are swapped for the lines
+     * the new text starts, and later lines move by the change in length.
+     * 
+     * @param[in] text The edited source buffer. Must outlive the map.
+     * @param[in] offset Start of the replaced range
+     * @param[in] removedLength Length of the replaced range
+     * @param[in] insertedLength Length of the text put in its place
+     */
+    void SourceMap::edit(std::string_view text, std::size_t offset, std::size_t removedLength, std::size_t insertedLength) {
+
+        this->text = text;
+        if (!built) {
+            return;
+        }
+
+        // A line starts just past each newline, so the replaced newlines
+        // start lines in (offset, offset + removedLength]
+        const auto removedBegin = std::upper_bound(lineStarts.begin() + 1, lineStarts.end(), offset);
+        const auto removedEnd = std::upper_bound(removedBegin, lineStarts.end(), offset + removedLength);
+        std::vector<std::size_t> inserted;
+        findNewlines(text.substr(offset, insertedLength), inserted);
+        for (auto& start : inserted) {
+            start += offset + 1;
+        }
+        auto later = lineStarts.erase(removedBegin, removedEnd);
+        later = lineStarts.insert(later, inserted.begin(), inserted.end()) + static_cast<std::ptrdiff_t>(inserted.size());
+        for (; later != lineStarts.end(); ++later) {
+            *later = *later - removedLength + insertedLength;
+        }
+    }
+
+    /**
+     * @brief Provides the line and column of a byte offset
+     * 
+     * @param[in] offset Byte offset, at most the size of the source
+     * @return The offset's location
+     */
+    SourceLocation SourceMap::locate(std::size_t offset) const {
+
+        build();
+        offset = std::min(offset, text.size());
+        const auto next = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+        const std::size_t line = static_cast<std::size_t>(next - lineStarts.begin());
+        const std::size_t start = lineStarts[line - 1];
+
+        return SourceLocation{line, countCodePoints(text.substr(start, offset - start)) + 1};
+    }
+
+    /**
+     * @brief Provides the number of lines, counting a final line without
+     *        a newline
+     */
+    std::size_t SourceMap::lineCount() const {
+        build();
+        return lineStarts.size();
+    }
+
+    /**
+     * @brief Provides the text of a line without its newline
+     * 
+     * @param[in] line Line number, from 1 to `lineCount()`
+     */
+    std::string_view SourceMap::lineText(std::size_t line) const {
+
+        build();
+        if (line == 0 || line > lineStarts.size()) {
+            return {};
+        }
+        const std::size_t start = lineStarts[line - 1];
+        const std::size_t end = line < lineStarts.size() ? lineStarts[line] - 1 : text.size();
+
+        return text.substr(start, end - start);
+    }
+
+}
@@ -0,0 +1,93 @@
+/**
+ * @file source_map.hpp
+ * 
+ * @brief Include file for mapping source offsets to lines and columns
+ */
+
+#ifndef SOURCE_MAP_HPP
+#define SOURCE_MAP_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace imperium_lang {
+
+    /**
+     * @brief A position in source text, both parts counted from 1
+     * 
+     * Columns count UTF-8 code points, not bytes.
+     */
+    struct SourceLocation {
+        std::size_t line;
+        std::size_t column;
+    };
+
+    /**
+     * @brief Maps byte offsets within a source buffer to lines and columns
+     * 
+     * The table of line starts is only built, in one vectorized pass, the
+     * first time a position is asked for, so lexing without errors never
+     * pays for it. Not safe to share between threads until it is built.
+     */
+    class SourceMap {
+    private:
+        std::string_view text;
+        mutable std::vector<std::size_t> lineStarts;
+        mutable bool built = false;
+
+        /**
+         * @brief Builds the line start table if it has not been yet
+         */
+        void build() const;
+    public:
+        /**
+         * @brief Constructor
+         * 
+         * @param[in] text The source buffer. Must outlive the map.
+         */
+        explicit SourceMap(std::string_view text = {}) : text(text) {}
+
+        /**
+         * @brief Points the map at another source buffer, dropping any table
+         * 
+         * @param[in] text The source buffer. Must outlive the map.
+         */
+        void reset(std::string_view text);
+
+        /**
+         * @brief Follows an edit of the source buffer, updating the table
+         *        for the edited range only
+         * 
+         * @param[in] text The edited source buffer. Must outlive the map.
+         * @param[in] offset Start of the replaced range
+         * @param[in] removedLength Length of the replaced range
+         * @param[in] insertedLength Length of the text put in its place
+         */
+        void edit(std::string_view text, std::size_t offset, std::size_t removedLength, std::size_t insertedLength);
+
+        /**
+         * @brief Provides the line and column of a byte offset
+         * 
+         * @param[in] offset Byte offset, at most the size of the source
+         * @return The offset's location
+         */
+        SourceLocation locate(std::size_t offset) const;
+
+        /**
+         * @brief Provides the number of lines, counting a final line without
+         *        a newline
+         */
+        std::size_t lineCount() const;
+
+        /**
+         * @brief Provides the text of a line without its newline
+         * 
+         * @param[in] line Line number, from 1 to `lineCount()`
+         */
+        std::string_view lineText(std::size_t line) const;
+    };
+
+}
+
+#endif
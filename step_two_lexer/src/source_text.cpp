@@ -0,0 +1,128 @@
+/**
+ * @file source_text.cpp
+ * 
+ * @brief Implementation file for loaded source file text
+ */
+
+#include "source_text.hpp"
+#include "lexer_stats.hpp"
+#include <iostream>
+
+namespace imperium_lang {
+
+    /**
+     * @brief Opens a source file, replacing any previously loaded text
+     * 
+     * @param[in] path The file to open
+     * @param[in, out] reader Reader for a file that cannot be mapped
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int SourceText::open(const std::string& path, StreamReader& reader) {
+
+        clear();
+        int mapStatus;
+        {
+            IMPERIUM_STATS(PhaseTimer timer(StatsPhase::Read);)
+            mapStatus = mapping.open(path);
+        }
+        if (mapStatus == 0) {
+            text = mapping.contents();
+            IMPERIUM_STATS(lexerStats().bytesRead += text.size();)
+            return 0;
+        } else if (mapStatus != 1 || reader.open(path) != 0) {
+            std::cerr << "Error: Failed to open source file.\n";
+            return -2;
+        }
+        this->reader = &reader;
+
+        return 0;
+    }
+
+    /**
+     * @brief Adds the next part of a source that is still being read
+     * 
+     * The reader thread counts the bytes it reads and the time it spends
+     * reading, so neither is counted again here.
+     * 
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 The text is complete; it is unchanged
+     * @retval -2 Read Error
+     */
+    int SourceText::readMore() {
+        if (reader == nullptr) {
+            return 1;
+        }
+
+        // An empty window hands every slot back before taking the next one
+        std::string_view window;
+        const int readStatus = reader->extend(window);
+        if (readStatus == 0) {
+            streamed.append(window);
+            text = streamed;
+            return 0;
+        }
+        stopReading();
+        if (readStatus == -2) {
+            std::cerr << "Error: Failed to read from source file.\n";
+            return -2;
+        }
+
+        return 1;
+    }
+
+    /**
+     * @brief Reads the rest of a source that is still being read
+     * 
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int SourceText::readRest() {
+        int readStatus = 0;
+        while (readStatus == 0) {
+            readStatus = readMore();
+        }
+
+        return readStatus == 1 ? 0 : readStatus;
+    }
+
+    /**
+     * @brief Loads a whole source file, replacing any previously loaded
+     *        text
+     * 
+     * @param[in] path The file to load
+     * @param[in, out] reader Reader used when the file cannot be mapped
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int SourceText::load(const std::string& path, StreamReader& reader) {
+        const int openStatus = open(path, reader);
+
+        return openStatus == 0 ? readRest() : openStatus;
+    }
+
+    /**
+     * @brief Stops reading, keeping the text read so far
+     */
+    void SourceText::stopReading() {
+        if (reader != nullptr) {
+            reader->close();
+            reader = nullptr;
+        }
+    }
+
+    /**
+     * @brief Drops the loaded text, keeping the memory reads went into
+     */
+    void SourceText::clear() {
+        stopReading();
+        mapping.close();
+        streamed.clear();
+        text = std::string_view{};
+    }
+
+}
@@ -0,0 +1,103 @@
+/**
+ * @file source_text.hpp
+ * 
+ * @brief Include file for loaded source file text
+ */
+
+#ifndef SOURCE_TEXT_HPP
+#define SOURCE_TEXT_HPP
+
+#include <string>
+#include <string_view>
+#include "mapped_file.hpp"
+#include "stream_reader.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief The whole text of a source file, kept alive for borrowed tokens
+     * 
+     * Regular files are memory mapped. Non-seekable inputs, such as pipes,
+     * are read ahead on the thread of a `StreamReader` into an owned
+     * string, which grows a slot at a time so the text read so far can be
+     * lexed while the rest is still being read.
+     */
+    class SourceText {
+    private:
+        MappedFile mapping;
+        StreamReader* reader = nullptr; // Set while the source is still being read
+        std::string streamed;
+        std::string_view text;
+    public:
+        /**
+         * @brief Opens a source file, replacing any previously loaded text
+         * 
+         * A file that can be mapped is loaded whole. Any other source is
+         * only started on `reader`, and the text grows as `readMore` is
+         * called.
+         * 
+         * @param[in] path The file to open
+         * @param[in, out] reader Reader for a file that cannot be mapped.
+         *                 Must not be used for anything else until the
+         *                 text is complete.
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Read Error
+         */
+        int open(const std::string& path, StreamReader& reader);
+
+        /**
+         * @brief Adds the next part of a source that is still being read
+         * 
+         * @return Status code
+         * @retval 0 Success
+         * @retval 1 The text is complete; it is unchanged
+         * @retval -2 Read Error
+         */
+        int readMore();
+
+        /**
+         * @brief Reads the rest of a source that is still being read
+         * 
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Read Error
+         */
+        int readRest();
+
+        /**
+         * @brief Loads a whole source file, replacing any previously loaded
+         *        text
+         * 
+         * @param[in] path The file to load
+         * @param[in, out] reader Reader used when the file cannot be mapped
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Read Error
+         */
+        int load(const std::string& path, StreamReader& reader);
+
+        /**
+         * @brief Stops reading, keeping the text read so far
+         */
+        void stopReading();
+
+        /**
+         * @brief Drops the loaded text, keeping the memory reads went into
+         */
+        void clear();
+
+        /**
+         * @brief Whether the whole source has been read
+         */
+        bool complete() const { return reader == nullptr; }
+
+        /**
+         * @brief Provides the text loaded so far
+         */
+        std::string_view view() const { return text; }
+    };
+
+}
+
+#endif
@@ -1,43 +1,274 @@
 /**
  * @file step_two.cpp
  * 
- * @brief Driver file to run a demo of the project reflecting the progress made in step one.
+ * @brief Driver file to run a demo of the project reflecting the progress made in step two.
  */
 
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
+#include "batch_tokenizer.hpp"
+#include "language_server.hpp"
+#include "lexer_stats.hpp"
+#include "token_dump.hpp"
 #include "tokenizer.hpp"
 
+namespace {
+
+    /**
+     * @brief How tokens are written out
+     */
+    enum class OutputFormat {
+        Text,
+        Binary,
+        None,
+    };
+
+    /**
+     * @brief Collects text in one large buffer and writes it out in big
+     *        blocks
+     */
+    class OutputBuffer {
+    private:
+        static constexpr std::size_t CAPACITY = 1 << 20;
+        std::ostream& out;
+        std::vector<char> buffer;
+    public:
+        explicit OutputBuffer(std::ostream& out) : out(out) { buffer.reserve(CAPACITY); }
+        ~OutputBuffer() { flush(); }
+        OutputBuffer(const OutputBuffer&) = delete;
+        OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+        OutputBuffer& operator<<(std::string_view text) {
+            if (buffer.size() + text.size() > CAPACITY) {
+                flush();
+                if (text.size() > CAPACITY) {
+                    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                    return *this;
+                }
+            }
+            buffer.insert(buffer.end(), text.begin(), text.end());
+            return *this;
+        }
+
+        void flush() {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    };
+
+    /**
+     * @brief Prints every token of a file, then the file rebuilt from them
+     * 
+     * @param[in] source The text the tokens borrow from
+     * @param[in] tokens The tokens to print
+     * @param[in, out] out The buffer to print into
+     */
+    void printTokens(std::string_view source, const std::vector<imperium_lang::TokenView>& tokens, OutputBuffer& out) {
+        if (tokens.empty()) {
+            out << "No tokens were returned.\n";
+            return;
+        }
+        out << "Tokens:\n";
+        for (const auto& token : tokens) {
+            out << "Type: " << imperium_lang::tokenTypeToString(token.type) << ", Value: " << token.text(source) << "\n";
+        }
+
+        out << "Reconstructing file from tokens:\n";
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            out << imperium_lang::leadingTrivia(tokens, i, source) << tokens[i].text(source);
+        }
+        out << "Done.\n";
+    }
+
+    /**
+     * @brief Prints the tokenizer's counters for people to read
+     * 
+     * @param[in] stats The counters to print
+     * @param[in, out] out The stream to print to
+     */
+    void printStats(const imperium_lang::LexerStats& stats, std::ostream& out) {
+        out << "Lexer statistics:\n"
+            << "  Bytes read: " << stats.bytesRead << "\n"
+            << "  Buffer refills: " << stats.refills << " (" << stats.bytesMoved << " bytes moved)\n"
+            << "  Keyword lookups: " << stats.keywordHits << " hits, " << stats.keywordMisses << " misses\n"
+            << "  Tokens:\n";
+        for (std::size_t type = 0; type < stats.tokens.size(); ++type) {
+            out << "    " << imperium_lang::tokenTypeToString(static_cast<imperium_lang::TokenType>(type))
+                << ": " << stats.tokens[type] << "\n";
+        }
+        out << "  Phase times:\n";
+        for (std::size_t phase = 0; phase < stats.phaseNanoseconds.size(); ++phase) {
+            out << "    " << imperium_lang::statsPhaseToString(static_cast<imperium_lang::StatsPhase>(phase))
+                << ": " << stats.phaseNanoseconds[phase] / 1e6 << " ms\n";
+        }
+    }
+
+    /**
+     * @brief Prints the tokenizer's counters as one JSON object
+     * 
+     * @param[in] stats The counters to print
+     * @param[in, out] out The stream to print to
+     */
+    void printStatsJson(const imperium_lang::LexerStats& stats, std::ostream& out) {
+        out << "{\"bytesRead\":" << stats.bytesRead
+            << ",\"refills\":" << stats.refills
+            << ",\"bytesMoved\":" << stats.bytesMoved
+            << ",\"keywordHits\":" << stats.keywordHits
+            << ",\"keywordMisses\":" << stats.keywordMisses
+            << ",\"tokens\":{";
+        for (std::size_t type = 0; type < stats.tokens.size(); ++type) {
+            out << (type == 0 ? "" : ",") << "\""
+                << imperium_lang::tokenTypeToString(static_cast<imperium_lang::TokenType>(type)) << "\":" << stats.tokens[type];
+        }
+        out << "},\"phaseNanoseconds\":{";
+        for (std::size_t phase = 0; phase < stats.phaseNanoseconds.size(); ++phase) {
+            out << (phase == 0 ? "" : ",") << "\""
+                << imperium_lang::statsPhaseToString(static_cast<imperium_lang::StatsPhase>(phase)) << "\":" << stats.phaseNanoseconds[phase];
+        }
+        out << "}}\n";
+    }
+}
+
 int main(int argc, char** argv) {
 
-    // Extract tokens from demo file
-    if (argc < 2) {
+    // Split options from source files and directories
+    std::size_t threadCount = 0;
+    std::string_view statsFormat{};
+    OutputFormat format = OutputFormat::Text;
+    std::string outputPath{};
+    std::string cacheDirectory{};
+    imperium_lang::TriviaMode trivia = imperium_lang::TriviaMode::Keep;
+    bool serve = false;
+    std::uintmax_t cacheMegabytes = imperium_lang::ContentCache::DEFAULT_MAX_BYTES >> 20;
+    std::vector<std::string> inputs{};
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+            threadCount = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--stats" || arg == "--stats=text") {
+            statsFormat = "text";
+        } else if (arg == "--stats=json") {
+            statsFormat = "json";
+        } else if (arg.starts_with("--stats=")) {
+            std::cerr << "Error: Unknown statistics format " << arg.substr(8) << ".\n";
+            return 1;
+        } else if (arg == "--format=text") {
+            format = OutputFormat::Text;
+        } else if (arg == "--format=binary") {
+            format = OutputFormat::Binary;
+        } else if (arg == "--format=none") {
+            format = OutputFormat::None;
+        } else if (arg.starts_with("--format=")) {
+            std::cerr << "Error: Unknown output format " << arg.substr(9) << ".\n";
+            return 1;
+        } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (arg == "--lsp") {
+            serve = true;
+        } else if (arg == "--skip-trivia") {
+            trivia = imperium_lang::TriviaMode::Skip;
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cacheDirectory = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            cacheMegabytes = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            inputs.emplace_back(arg);
+        }
+    }
+
+    // Serve an editor over standard input and output until it exits
+    if (serve) {
+        std::ios::sync_with_stdio(false);
+        return imperium_lang::LanguageServer(std::cout).run(std::cin);
+    }
+    if (inputs.empty()) {
         std::cerr << "Error: No source file provided.\n";
         return 1;
     }
-    imperium_lang::Tokenizer tokenizer{argv[1]};
-    std::vector<imperium_lang::Token> tokens{};
-    const auto status = tokenizer.tokenize(tokens);
-    if (status != 0) {
-        std::cerr << "Error: Tokenization failed.\n";
+
+    // Extract tokens from every source file
+    std::vector<std::string> paths{};
+    if (imperium_lang::collectSourceFiles(inputs, paths) != 0) {
         return -1;
     }
+    std::vector<imperium_lang::FileTokens> results{};
+    imperium_lang::BatchStats stats{};
+    std::optional<imperium_lang::ContentCache> cache{};
+    if (!cacheDirectory.empty()) {
+        cache.emplace(cacheDirectory, cacheMegabytes << 20);
+    }
+    imperium_lang::resetLexerStats();
+    const auto status = imperium_lang::tokenizeFiles(paths, results, stats, threadCount, cache ? &*cache : nullptr, trivia);
+    const auto lexerStats = imperium_lang::collectLexerStats();
 
-    // Output token data
-    if (tokens.empty()) {
-        std::cout << "No tokens were returned.\n";
-    } else {
-        std::cout << "Tokens:\n";
-        for (const auto& token : tokens) {
-            std::cout << "Type: " << imperium_lang::tokenTypeToString(token.type) << ", Value: " << token.value << "\n";
+    // Output token data in input order
+    std::ios::sync_with_stdio(false);
+    std::ofstream outputFile{};
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath, std::ios::binary);
+        if (!outputFile) {
+            std::cerr << "Error: Failed to open output file.\n";
+            return -2;
         }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : outputFile;
+    int writeStatus = 0;
+    {
+        OutputBuffer text(out);
+        for (const auto& result : results) {
+            if (result.status != 0) {
+                std::cerr << "Error: Tokenization failed for " << result.path << ".\n";
+            }
+            if (format == OutputFormat::Binary) {
 
-        std::cout << "Reconstructing file from tokens:\n";
-        for (const auto& token : tokens) {
-            std::cout << token.value;
+                // Failed files still get an empty dump so dumps line up with inputs
+                const auto source = result.status == 0 ? result.source.view() : std::string_view{};
+                const auto tokens = result.status == 0 ? std::span(result.tokens) : std::span<const imperium_lang::TokenView>{};
+                if (imperium_lang::writeTokenDump(source.size(), tokens, out) != 0) {
+                    writeStatus = -1;
+                }
+                continue;
+            } else if (format == OutputFormat::None) {
+                continue;
+            }
+            if (results.size() > 1) {
+                text << "File: " << result.path << "\n";
+            }
+            if (result.status == 0) {
+                printTokens(result.source.view(), result.tokens, text);
+            }
         }
-        std::cout << "Done.\n";
     }
 
-    return 0;
+    // Binary dumps on standard output leave no room for the summaries
+    std::ostream& report = format == OutputFormat::Binary && outputPath.empty() ? std::cerr : std::cout;
+    if (results.size() > 1) {
+        report << "Tokenized " << stats.files << " files (" << stats.bytes << " bytes, " << stats.tokens << " tokens) in "
+            << stats.seconds * 1e3 << " ms on " << stats.threads << " threads: "
+            << stats.megabytesPerSecond() << " MB/s, " << stats.tokensPerSecond() << " tokens/s";
+        if (cache) {
+            report << ", " << stats.cacheHits << " cached";
+        }
+        report << "\n";
+    }
+    if (!statsFormat.empty() && !imperium_lang::LEXER_STATS_ENABLED) {
+        std::cerr << "Error: Statistics were not compiled in. Rebuild with -DLEXER_STATS=ON.\n";
+    } else if (statsFormat == "json") {
+        printStatsJson(lexerStats, report);
+    } else if (statsFormat == "text") {
+        printStats(lexerStats, report);
+    }
+    out.flush();
+    if (!out) {
+        std::cerr << "Error: Failed to write output.\n";
+        return -2;
+    }
+
+    return status == 0 && writeStatus == 0 ? 0 : -1;
 }
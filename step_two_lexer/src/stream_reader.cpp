@@ -0,0 +1,173 @@
+/**
+ * @file stream_reader.cpp
+ * 
+ * @brief Implementation file for the read-ahead reader of streamed sources
+ */
+
+#include "stream_reader.hpp"
+#include "lexer_stats.hpp"
+#include <algorithm>
+
+namespace imperium_lang {
+
+    StreamReader::~StreamReader() {
+        close();
+    }
+
+    /**
+     * @brief Opens a source and starts reading it ahead
+     * 
+     * Any source already open is closed first.
+     * 
+     * @param[in] path Path of the source to read
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int StreamReader::open(const std::string& path) {
+        close();
+        stream.open(path, std::ios::binary);
+        if (!stream) {
+            stream.clear();
+            return -2;
+        }
+        if (!storage) {
+
+            // The area before the first slot takes what is left of the
+            // window when it wraps around, which is at most every other slot
+            storage = std::make_unique_for_overwrite<char[]>(SLOT_SIZE * (SLOT_COUNT * 2 - 1));
+        }
+        filled.fill(false);
+        lengths.fill(0);
+        finished = false;
+        failed = false;
+        stopping = false;
+        firstHeld = 0;
+        heldCount = 0;
+        thread = std::thread(&StreamReader::readLoop, this);
+
+        return 0;
+    }
+
+    /**
+     * @brief Stops the reader thread and drops all buffered data
+     * 
+     * A reader blocked on a source that has no data yet is waited for.
+     */
+    void StreamReader::close() {
+        if (thread.joinable()) {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            slotFreed.notify_one();
+            thread.join();
+        }
+        if (stream.is_open()) {
+            stream.close();
+        }
+        stream.clear();
+    }
+
+    /**
+     * @brief Main loop of the reader thread
+     */
+    void StreamReader::readLoop() {
+        for (std::size_t slot = 0;; slot = (slot + 1) % SLOT_COUNT) {
+            {
+                std::unique_lock lock(mutex);
+                slotFreed.wait(lock, [&] { return stopping || !filled[slot]; });
+                if (stopping) {
+                    return;
+                }
+            }
+            std::size_t length;
+            {
+                IMPERIUM_STATS(PhaseTimer timer(StatsPhase::Read);)
+                stream.read(slotData(slot), SLOT_SIZE);
+                length = static_cast<std::size_t>(stream.gcount());
+            }
+            IMPERIUM_STATS(lexerStats().bytesRead += length;)
+            const bool done = !stream;
+            {
+                std::lock_guard lock(mutex);
+                lengths[slot] = length;
+                filled[slot] = true;
+                finished = done;
+                failed = stream.bad();
+            }
+            slotFilled.notify_one();
+            if (done) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Grows a window of read data by the next slot
+     * 
+     * Slots the window has moved past are handed back to the reader
+     * thread first. The window must be empty or one this reader
+     * returned, possibly with a prefix removed.
+     * 
+     * @param[in, out] window View of the data not yet consumed
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 End of file reached; the window is unchanged
+     * @retval 2 The window cannot grow any further; it is unchanged
+     * @retval -2 Read Error
+     */
+    int StreamReader::extend(std::string_view& window) {
+        std::unique_lock lock(mutex);
+
+        // Hand back the slots the window no longer reaches into
+        bool freed = false;
+        while (heldCount > 0 && (window.empty() || window.data() >= slotData(firstHeld) + SLOT_SIZE)) {
+            filled[firstHeld] = false;
+            firstHeld = (firstHeld + 1) % SLOT_COUNT;
+            --heldCount;
+            freed = true;
+        }
+        if (freed) {
+            slotFreed.notify_one();
+        }
+        if (heldCount == SLOT_COUNT || window.size() > SLOT_SIZE * (SLOT_COUNT - 1)) {
+            return 2;
+        }
+
+        // Wait for the reader to fill the slot after the window
+        const std::size_t slot = (firstHeld + heldCount) % SLOT_COUNT;
+        slotFilled.wait(lock, [&] { return filled[slot] || finished; });
+        if (!filled[slot] || lengths[slot] == 0) {
+            return failed ? -2 : 1;
+        }
+
+        // Only a window wrapping back to the first slot has to move
+        const std::size_t length = lengths[slot];
+        if (window.empty()) {
+            firstHeld = slot;
+            heldCount = 1;
+            window = std::string_view(slotData(slot), length);
+        } else if (slot == 0) {
+            char* start = slotData(0) - window.size();
+            std::copy(window.begin(), window.end(), start);
+            IMPERIUM_STATS(lexerStats().bytesMoved += window.size();)
+            while (heldCount > 0) {
+                filled[firstHeld] = false;
+                firstHeld = (firstHeld + 1) % SLOT_COUNT;
+                --heldCount;
+            }
+            slotFreed.notify_one();
+            firstHeld = 0;
+            heldCount = 1;
+            window = std::string_view(start, window.size() + length);
+        } else {
+            ++heldCount;
+            window = std::string_view(window.data(), window.size() + length);
+        }
+        IMPERIUM_STATS(++lexerStats().refills;)
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,112 @@
+/**
+ * @file stream_reader.hpp
+ * 
+ * @brief Include file for the read-ahead reader of streamed sources
+ */
+
+#ifndef STREAM_READER_HPP
+#define STREAM_READER_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace imperium_lang {
+
+    /**
+     * @brief Reads a source that cannot be mapped, such as a pipe, on a
+     *        thread of its own so reading overlaps with lexing
+     * 
+     * The reader thread fills a ring of slots laid out back to back in one
+     * allocation, running ahead of the consumer until every slot is full.
+     * The consumer sees the data as one window that grows at its end and
+     * shrinks at its front. A window that reaches into the next slot is
+     * simply extended over it, so tokens that span slots are never copied.
+     * Only when the window wraps from the last slot back to the first is
+     * its remainder copied, into a spare area placed just before the first
+     * slot. The window never holds more than `SLOT_COUNT` slots' worth of
+     * data.
+     */
+    class StreamReader {
+    public:
+        static constexpr std::size_t SLOT_COUNT = 4;
+        static constexpr std::size_t SLOT_SIZE = 1 << 18;
+    private:
+        std::unique_ptr<char[]> storage;
+        std::ifstream stream;
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable slotFilled;
+        std::condition_variable slotFreed;
+        std::array<std::size_t, SLOT_COUNT> lengths{};
+        std::array<bool, SLOT_COUNT> filled{};
+        bool finished = false;
+        bool failed = false;
+        bool stopping = false;
+
+        // Consumer side only
+        std::size_t firstHeld = 0;
+        std::size_t heldCount = 0;
+
+        /**
+         * @brief Provides the start of a slot
+         * 
+         * @param[in] slot Slot index, below `SLOT_COUNT`
+         */
+        char* slotData(std::size_t slot) const { return storage.get() + SLOT_SIZE * (SLOT_COUNT - 1 + slot); }
+
+        /**
+         * @brief Main loop of the reader thread
+         */
+        void readLoop();
+    public:
+        StreamReader() = default;
+        StreamReader(const StreamReader&) = delete;
+        StreamReader& operator=(const StreamReader&) = delete;
+        ~StreamReader();
+
+        /**
+         * @brief Opens a source and starts reading it ahead
+         * 
+         * Any source already open is closed first.
+         * 
+         * @param[in] path Path of the source to read
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Read Error
+         */
+        int open(const std::string& path);
+
+        /**
+         * @brief Stops the reader thread and drops all buffered data
+         * 
+         * A reader blocked on a source that has no data yet is waited for.
+         */
+        void close();
+
+        /**
+         * @brief Grows a window of read data by the next slot
+         * 
+         * Slots the window has moved past are handed back to the reader
+         * thread first. The window must be empty or one this reader
+         * returned, possibly with a prefix removed.
+         * 
+         * @param[in, out] window View of the data not yet consumed
+         * @return Status code
+         * @retval 0 Success
+         * @retval 1 End of file reached; the window is unchanged
+         * @retval 2 The window cannot grow any further; it is unchanged
+         * @retval -2 Read Error
+         */
+        int extend(std::string_view& window);
+    };
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file symbol_table.cpp
+ * 
+ * @brief Implementation file for the identifier interning table
+ */
+
+#include "symbol_table.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    constexpr std::uint64_t SEED_0 = 0xa0761d6478bd642full;
+    constexpr std::uint64_t SEED_1 = 0xe7037ed1a0b428dbull;
+    constexpr std::uint64_t SEED_2 = 0x8ebc6af09c88c6e3ull;
+
+    constexpr std::size_t INITIAL_SLOTS = 1024; // Must be a power of two
+
+    /**
+     * @brief Multiplies two 64-bit values and folds the 128-bit product
+     */
+    inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) {
+#ifdef __SIZEOF_INT128__
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+        const std::uint64_t product = a * (b | 1);
+        return product ^ (product >> 32) ^ b;
+#endif
+    }
+
+    /**
+     * @brief Reads up to 8 bytes as a little endian integer
+     */
+    inline std::uint64_t read(const char* bytes, std::size_t count) {
+        std::uint64_t value = 0;
+        std::memcpy(&value, bytes, count);
+        return value;
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Hashes a byte string, mixing 8 bytes at a time in the style of wyhash
+     * 
+     * @param[in] bytes The bytes to hash
+     * @return 64-bit hash of the bytes
+     */
+    std::uint64_t hashBytes(std::string_view bytes) {
+        const char* data = bytes.data();
+        std::size_t remaining = bytes.size();
+        std::uint64_t state = SEED_0 ^ mix(bytes.size() ^ SEED_0, SEED_1);
+        while (remaining > 16) {
+            state = mix(read(data, 8) ^ SEED_1, read(data + 8, 8) ^ state);
+            data += 16;
+            remaining -= 16;
+        }
+        std::uint64_t low = 0;
+        std::uint64_t high = 0;
+        if (remaining > 8) {
+            low = read(data, 8);
+            high = read(data + 8, remaining - 8);
+        } else {
+            low = read(data, remaining);
+        }
+        return mix(SEED_1 ^ bytes.size(), mix(low ^ SEED_1, high ^ state) ^ SEED_2);
+    }
+
+    /**
+     * @brief Interns a name
+     * 
+     * @param[in] name The name to intern
+     * @return The id of the name, allocated if it was not seen before
+     */
+    SymbolId SymbolTable::intern(std::string_view name) {
+
+        // Keep the load factor at or below one half
+        if ((names.size() + 1) * 2 > slots.size()) {
+            grow();
+        }
+        const std::uint64_t hash = hashBytes(name);
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t index = hash & mask;; index = (index + 1) & mask) {
+            Slot& slot = slots[index];
+            if (slot.id == NO_SYMBOL) {
+                slot.hash = hash;
+                slot.id = static_cast<SymbolId>(names.size());
+                names.push_back(store(name));
+                return slot.id;
+            }
+            if (slot.hash == hash && names[slot.id] == name) {
+                return slot.id;
+            }
+        }
+    }
+
+    /**
+     * @brief Forgets every symbol while keeping the allocated memory
+     */
+    void SymbolTable::clear() {
+        std::fill(slots.begin(), slots.end(), Slot{0, NO_SYMBOL});
+        names.clear();
+        oversizedNames.clear();
+
+        // Keep every arena block so a table reused for file after file
+        // stops allocating once it has held the largest one
+        arenaBlocksUsed = 0;
+        arenaCursor = nullptr;
+        arenaRemaining = 0;
+    }
+
+    /**
+     * @brief Copies a name into the arena
+     * 
+     * @param[in] name The name to copy
+     * @return View of the arena copy
+     */
+    std::string_view SymbolTable::store(std::string_view name) {
+        if (name.size() > arenaRemaining) {
+            // Oversized names get a block of their own so the current block is not wasted
+            if (name.size() > ARENA_BLOCK_SIZE / 4) {
+                oversizedNames.push_back(std::make_unique_for_overwrite<char[]>(name.size()));
+                std::memcpy(oversizedNames.back().get(), name.data(), name.size());
+                return std::string_view(oversizedNames.back().get(), name.size());
+            }
+            // Blocks kept by `clear` are filled again before new ones are made
+            if (arenaBlocksUsed == arenaBlocks.size()) {
+                arenaBlocks.push_back(std::make_unique_for_overwrite<char[]>(ARENA_BLOCK_SIZE));
+            }
+            arenaCursor = arenaBlocks[arenaBlocksUsed++].get();
+            arenaRemaining = ARENA_BLOCK_SIZE;
+        }
+        std::memcpy(arenaCursor, name.data(), name.size());
+        const std::string_view stored(arenaCursor, name.size());
+        arenaCursor += name.size();
+        arenaRemaining -= name.size();
+        return stored;
+    }
+
+    /**
+     * @brief Doubles the hash table and reinserts every symbol
+     */
+    void SymbolTable::grow() {
+        std::vector<Slot> grown(slots.empty() ? INITIAL_SLOTS : slots.size() * 2, Slot{0, NO_SYMBOL});
+        const std::size_t mask = grown.size() - 1;
+        for (const Slot& slot : slots) {
+            if (slot.id == NO_SYMBOL) {
+                continue;
+            }
+            std::size_t index = slot.hash & mask;
+            while (grown[index].id != NO_SYMBOL) {
+                index = (index + 1) & mask;
+            }
+            grown[index] = slot;
+        }
+        slots.swap(grown);
+    }
+
+}
@@ -0,0 +1,97 @@
+/**
+ * @file symbol_table.hpp
+ * 
+ * @brief Include file for the identifier interning table
+ */
+
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace imperium_lang {
+
+    using SymbolId = std::uint32_t;
+
+    constexpr SymbolId NO_SYMBOL = UINT32_MAX;
+
+    /**
+     * @brief Hashes a byte string, mixing 8 bytes at a time in the style of wyhash
+     * 
+     * @param[in] bytes The bytes to hash
+     * @return 64-bit hash of the bytes
+     */
+    std::uint64_t hashBytes(std::string_view bytes);
+
+    /**
+     * @brief Interns identifiers so each distinct name is stored once and
+     *        can be compared by a 32-bit id
+     * 
+     * Names are copied into an arena of fixed size blocks and found again
+     * through an open addressing hash table with linear probing. Ids are
+     * dense and handed out in first-seen order.
+     */
+    class SymbolTable {
+    private:
+        static constexpr std::size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+        struct Slot {
+            std::uint64_t hash;
+            SymbolId id; // NO_SYMBOL if the slot is empty
+        };
+
+        std::vector<Slot> slots;
+        std::vector<std::string_view> names;
+        std::vector<std::unique_ptr<char[]>> arenaBlocks;
+        std::vector<std::unique_ptr<char[]>> oversizedNames;
+        std::size_t arenaBlocksUsed = 0;
+        char* arenaCursor = nullptr;
+        std::size_t arenaRemaining = 0;
+
+        /**
+         * @brief Copies a name into the arena
+         * 
+         * @param[in] name The name to copy
+         * @return View of the arena copy
+         */
+        std::string_view store(std::string_view name);
+
+        /**
+         * @brief Doubles the hash table and reinserts every symbol
+         */
+        void grow();
+    public:
+        /**
+         * @brief Interns a name
+         * 
+         * @param[in] name The name to intern
+         * @return The id of the name, allocated if it was not seen before
+         */
+        SymbolId intern(std::string_view name);
+
+        /**
+         * @brief Provides the name of an interned symbol
+         * 
+         * @param[in] id The symbol id
+         * @return View of the name, valid until the table is cleared or destroyed
+         */
+        std::string_view name(SymbolId id) const { return names[id]; }
+
+        /**
+         * @brief Provides the number of distinct symbols
+         */
+        std::size_t size() const { return names.size(); }
+
+        /**
+         * @brief Forgets every symbol while keeping the allocated memory
+         */
+        void clear();
+    };
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file thread_pool.cpp
+ * 
+ * @brief Implementation file for the work stealing thread pool
+ */
+
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace imperium_lang {
+
+    /**
+     * @brief Constructor
+     * 
+     * @param[in] threadCount Number of worker threads. 0 uses one per core.
+     */
+    WorkStealingPool::WorkStealingPool(std::size_t threadCount) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            std::lock_guard lock(stateMutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Runs `task` for every index in `[0, count)` and waits for
+     *        all of them to finish
+     * 
+     * @param[in] count Number of task indices
+     * @param[in] task The task to run for each index
+     */
+    void WorkStealingPool::parallelFor(std::size_t count, const Task& task) {
+
+        if (count == 0) {
+            return;
+        }
+
+        // Publish the task before any index of it can be taken
+        currentTask.store(&task, std::memory_order_release);
+        pending.store(count, std::memory_order_release);
+
+        // Deal contiguous runs of indices to each worker
+        const std::size_t workers = queues.size();
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            const std::size_t begin = count * worker / workers;
+            const std::size_t end = count * (worker + 1) / workers;
+            std::lock_guard lock(queues[worker]->mutex);
+            for (std::size_t index = begin; index < end; ++index) {
+                queues[worker]->indices.push_back(index);
+            }
+        }
+
+        std::unique_lock lock(stateMutex);
+        ++generation;
+        workAvailable.notify_all();
+        workDone.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    /**
+     * @brief Main loop of a worker thread
+     * 
+     * @param[in] worker Index of the worker
+     */
+    void WorkStealingPool::workerLoop(std::size_t worker) {
+
+        std::size_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock lock(stateMutex);
+                workAvailable.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if (stopping) {
+                    return;
+                }
+                seenGeneration = generation;
+            }
+
+            std::size_t index;
+            while (takeTask(worker, index)) {
+                (*currentTask.load(std::memory_order_acquire))(worker, index);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard lock(stateMutex);
+                    workDone.notify_all();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Takes the next task index from the worker's own queue or
+     *        steals one from another worker
+     * 
+     * @param[in] worker Index of the worker looking for work
+     * @param[out] index The task index taken
+     * @return Whether a task index was taken
+     */
+    bool WorkStealingPool::takeTask(std::size_t worker, std::size_t& index) {
+
+        {
+            WorkerQueue& own = *queues[worker];
+            std::lock_guard lock(own.mutex);
+            if (!own.indices.empty()) {
+                index = own.indices.back();
+                own.indices.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+            WorkerQueue& victim = *queues[(worker + offset) % queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.indices.empty()) {
+                index = victim.indices.front();
+                victim.indices.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+}
@@ -0,0 +1,99 @@
+/**
+ * @file thread_pool.hpp
+ * 
+ * @brief Include file for the work stealing thread pool
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace imperium_lang {
+
+    /**
+     * @brief Fixed set of worker threads that share batches of indexed tasks
+     * 
+     * Each worker owns a queue of task indices. A worker takes work from
+     * the back of its own queue and, once that is empty, steals from the
+     * front of the other workers' queues, so uneven task sizes still keep
+     * every core busy.
+     */
+    class WorkStealingPool {
+    public:
+        /**
+         * @brief Task run for one index
+         * 
+         * @param[in] worker Index of the worker running the task, below `size()`
+         * @param[in] index Index of the task
+         */
+        using Task = std::function<void(std::size_t worker, std::size_t index)>;
+    private:
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<std::size_t> indices;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> threads;
+        std::mutex stateMutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workDone;
+        std::atomic<const Task*> currentTask{nullptr};
+        std::atomic<std::size_t> pending{0};
+        std::size_t generation = 0;
+        bool stopping = false;
+
+        /**
+         * @brief Main loop of a worker thread
+         * 
+         * @param[in] worker Index of the worker
+         */
+        void workerLoop(std::size_t worker);
+
+        /**
+         * @brief Takes the next task index from the worker's own queue or
+         *        steals one from another worker
+         * 
+         * @param[in] worker Index of the worker looking for work
+         * @param[out] index The task index taken
+         * @return Whether a task index was taken
+         */
+        bool takeTask(std::size_t worker, std::size_t& index);
+    public:
+        /**
+         * @brief Constructor
+         * 
+         * @param[in] threadCount Number of worker threads. 0 uses one per core.
+         */
+        explicit WorkStealingPool(std::size_t threadCount = 0);
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+        ~WorkStealingPool();
+
+        /**
+         * @brief Provides the number of worker threads
+         */
+        std::size_t size() const { return threads.size(); }
+
+        /**
+         * @brief Runs `task` for every index in `[0, count)` and waits for
+         *        all of them to finish
+         * 
+         * @param[in] count Number of task indices
+         * @param[in] task The task to run for each index
+         */
+        void parallelFor(std::size_t count, const Task& task);
+    };
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file token_buffer.cpp
+ * 
+ * @brief Implementation file for the struct-of-arrays token container
+ */
+
+#include "token_buffer.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief Appends a token
+     * 
+     * @param[in] token The token to append. Its offset and length must
+     *            fit in 32 bits.
+     */
+    void TokenBuffer::push(const TokenView& token) {
+        kindColumn.push_back(token.type);
+        offsetColumn.push_back(static_cast<std::uint32_t>(token.offset));
+        lengthColumn.push_back(static_cast<std::uint32_t>(token.length));
+        if (keepPayloads) {
+            std::uint32_t payload = 0;
+            if (token.type == ReservedWord) {
+                payload = static_cast<std::uint32_t>(token.keyword);
+            } else if (token.type == CharSequence) {
+                payload = token.symbol;
+            } else if (token.type == OperatorSequence) {
+                payload = static_cast<std::uint32_t>(token.op);
+            } else if (token.type == Number) {
+                payload = token.number;
+            }
+            payloadColumn.push_back(payload);
+        }
+    }
+
+    /**
+     * @brief Removes every token, keeping the allocated storage
+     */
+    void TokenBuffer::clear() {
+        kindColumn.clear();
+        offsetColumn.clear();
+        lengthColumn.clear();
+        payloadColumn.clear();
+    }
+
+    /**
+     * @brief Allocates storage for at least `count` tokens
+     * 
+     * @param[in] count Number of tokens to make room for
+     */
+    void TokenBuffer::reserve(std::size_t count) {
+        kindColumn.reserve(count);
+        offsetColumn.reserve(count);
+        lengthColumn.reserve(count);
+        if (keepPayloads) {
+            payloadColumn.reserve(count);
+        }
+    }
+
+}
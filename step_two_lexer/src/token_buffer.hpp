@@ -0,0 +1,165 @@
+/**
+ * @file token_buffer.hpp
+ * 
+ * @brief Include file for the struct-of-arrays token container
+ */
+
+#ifndef TOKEN_BUFFER_HPP
+#define TOKEN_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "tokenizer.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief Tokens stored as one array per field
+     * 
+     * Kinds, offsets and lengths live in separate arrays, so a scan over
+     * token kinds touches one byte per token. Offsets and lengths are 32
+     * bits wide, limiting sources to 4 GiB.
+     * 
+     * The payload array is optional. When kept, it holds the `Keyword` of
+     * `ReservedWord` tokens, the `SymbolId` of `CharSequence` tokens, the
+     * `OperatorKind` of `OperatorSequence` tokens and the `NumberId` of
+     * `Number` tokens. Without it, tokens read back with none of them set.
+     */
+    class TokenBuffer {
+    private:
+        std::vector<TokenType> kindColumn;
+        std::vector<std::uint32_t> offsetColumn;
+        std::vector<std::uint32_t> lengthColumn;
+        std::vector<std::uint32_t> payloadColumn;
+        bool keepPayloads;
+    public:
+        static constexpr std::size_t MAX_SOURCE_SIZE = UINT32_MAX;
+
+        /**
+         * @brief Iterator yielding each token as a `TokenView`
+         */
+        class Iterator {
+        private:
+            const TokenBuffer* buffer = nullptr;
+            std::size_t index = 0;
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = TokenView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = TokenView;
+
+            Iterator() = default;
+            Iterator(const TokenBuffer* buffer, std::size_t index) : buffer(buffer), index(index) {}
+
+            TokenView operator*() const { return (*buffer)[index]; }
+            TokenView operator[](difference_type n) const { return (*buffer)[index + n]; }
+            Iterator& operator++() { ++index; return *this; }
+            Iterator operator++(int) { Iterator old = *this; ++index; return old; }
+            Iterator& operator--() { --index; return *this; }
+            Iterator operator--(int) { Iterator old = *this; --index; return old; }
+            Iterator& operator+=(difference_type n) { index += n; return *this; }
+            Iterator& operator-=(difference_type n) { index -= n; return *this; }
+            friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+            friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+            friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const Iterator& a, const Iterator& b) {
+                return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+            }
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.index == b.index; }
+            friend auto operator<=>(const Iterator& a, const Iterator& b) { return a.index <=> b.index; }
+        };
+
+        /**
+         * @brief Constructor
+         * 
+         * @param[in] keepPayloads Whether to store keyword, symbol, operator and number payloads
+         */
+        explicit TokenBuffer(bool keepPayloads = true) : keepPayloads(keepPayloads) {}
+
+        /**
+         * @brief Appends a token
+         * 
+         * @param[in] token The token to append. Its offset and length must
+         *            fit in 32 bits.
+         */
+        void push(const TokenView& token);
+
+        /**
+         * @brief Removes every token, keeping the allocated storage
+         */
+        void clear();
+
+        /**
+         * @brief Allocates storage for at least `count` tokens
+         * 
+         * @param[in] count Number of tokens to make room for
+         */
+        void reserve(std::size_t count);
+
+        /**
+         * @brief Provides the number of tokens
+         */
+        std::size_t size() const { return kindColumn.size(); }
+
+        /**
+         * @brief Provides whether there are no tokens
+         */
+        bool empty() const { return kindColumn.empty(); }
+
+        /**
+         * @brief Provides whether payloads are stored
+         */
+        bool hasPayloads() const { return keepPayloads; }
+
+        /**
+         * @brief Provides a token
+         * 
+         * @param[in] index Token index, below `size()`
+         */
+        TokenView operator[](std::size_t index) const {
+            TokenView token{kindColumn[index], offsetColumn[index], lengthColumn[index]};
+            if (keepPayloads) {
+                if (token.type == ReservedWord) {
+                    token.keyword = static_cast<Keyword>(payloadColumn[index]);
+                } else if (token.type == CharSequence) {
+                    token.symbol = payloadColumn[index];
+                } else if (token.type == OperatorSequence) {
+                    token.op = static_cast<OperatorKind>(payloadColumn[index]);
+                } else if (token.type == Number) {
+                    token.number = payloadColumn[index];
+                }
+            }
+            return token;
+        }
+
+        /**
+         * @brief Provides the text of a token
+         * 
+         * @param[in] index Token index, below `size()`
+         * @param[in] source The source buffer the tokens were extracted from
+         */
+        std::string_view text(std::size_t index, std::string_view source) const {
+            return source.substr(offsetColumn[index], lengthColumn[index]);
+        }
+
+        std::span<const TokenType> kinds() const { return kindColumn; }
+        std::span<const std::uint32_t> offsets() const { return offsetColumn; }
+        std::span<const std::uint32_t> lengths() const { return lengthColumn; }
+
+        /**
+         * @brief Provides the payload array, empty when payloads are not kept
+         */
+        std::span<const std::uint32_t> payloads() const { return payloadColumn; }
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end() const { return Iterator(this, size()); }
+    };
+
+}
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file token_dump.cpp
+ * 
+ * @brief Implementation file for the binary token dump format
+ */
+
+#include "token_dump.hpp"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+    /**
+     * @brief Writes the raw bytes of an array
+     * 
+     * @param[in] values The array to write
+     * @param[in, out] out The stream to write to
+     */
+    template <typename T>
+    void writeArray(std::span<const T> values, std::ostream& out) {
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+    }
+
+    /**
+     * @brief Provides the payload column entry of a token
+     * 
+     * @param[in] token The token
+     */
+    std::uint32_t tokenPayload(const imperium_lang::TokenView& token) {
+        switch (token.type) {
+            case imperium_lang::TokenType::ReservedWord: return static_cast<std::uint32_t>(token.keyword);
+            case imperium_lang::TokenType::OperatorSequence: return static_cast<std::uint32_t>(token.op);
+            case imperium_lang::TokenType::Number: return token.number;
+            default: return token.symbol;
+        }
+    }
+}
+
+namespace imperium_lang {
+
+    /**
+     * @brief Writes tokens as one binary dump
+     * 
+     * @param[in] sourceSize Size of the source the tokens were lexed from.
+     *            Must be below 4 GiB.
+     * @param[in] tokens The tokens to write
+     * @param[in, out] out The stream to write to
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 The source is too large for the format
+     * @retval -2 Write Error
+     */
+    int writeTokenDump(std::size_t sourceSize, std::span<const TokenView> tokens, std::ostream& out) {
+
+        if (sourceSize > UINT32_MAX) {
+            std::cerr << "Error: Source is too large for a token dump.\n";
+            return -1;
+        }
+        TokenDumpHeader header{};
+        header.tokenCount = static_cast<std::uint32_t>(tokens.size());
+        header.sourceSize = static_cast<std::uint32_t>(sourceSize);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Each array is gathered and written whole rather than a field at a time
+        std::vector<TokenType> kinds((tokens.size() + 3) / 4 * 4, TokenType::Invalid);
+        std::vector<std::uint32_t> column(tokens.size());
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            kinds[i] = tokens[i].type;
+        }
+        writeArray<TokenType>(kinds, out);
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            column[i] = static_cast<std::uint32_t>(tokens[i].offset);
+        }
+        writeArray<std::uint32_t>(column, out);
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            column[i] = static_cast<std::uint32_t>(tokens[i].length);
+        }
+        writeArray<std::uint32_t>(column, out);
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            column[i] = tokenPayload(tokens[i]);
+        }
+        writeArray<std::uint32_t>(column, out);
+        if (!out) {
+            std::cerr << "Error: Failed to write token dump.\n";
+            return -2;
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Reads the first dump in a byte range without copying it
+     * 
+     * A well formed dump has only known token kinds, keywords and operators,
+     * and its tokens run in order up to the end of the source. They leave
+     * no gaps, unless trivia was skipped and the last token is the
+     * `EndOfFile`.
+     * 
+     * @param[in] data Bytes of one or more dumps. Must be 4-byte aligned,
+     *            as mapped files are.
+     * @param[out] dump The dump's arrays, pointing into `data`
+     * @param[out] bytesUsed Size of the dump, where the next one starts
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 `data` is empty
+     * @retval -1 `data` does not start with a well formed dump
+     */
+    int readTokenDump(std::string_view data, TokenDump& dump, std::size_t& bytesUsed) {
+
+        if (data.empty()) {
+            return 1;
+        }
+        TokenDumpHeader header{};
+        if (data.size() < sizeof(header) || reinterpret_cast<std::uintptr_t>(data.data()) % alignof(std::uint32_t) != 0) {
+            std::cerr << "Error: Token dump is truncated or misaligned.\n";
+            return -1;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic != TokenDumpHeader{}.magic || header.version != TokenDumpHeader{}.version) {
+            std::cerr << "Error: Not a supported token dump.\n";
+            return -1;
+        }
+        bytesUsed = tokenDumpSize(header.tokenCount);
+        if (data.size() < bytesUsed) {
+            std::cerr << "Error: Token dump is truncated or misaligned.\n";
+            return -1;
+        }
+
+        const char* kinds = data.data() + sizeof(header);
+        const char* offsets = kinds + (header.tokenCount + 3) / 4 * 4;
+        const char* lengths = offsets + header.tokenCount * sizeof(std::uint32_t);
+        const char* payloads = lengths + header.tokenCount * sizeof(std::uint32_t);
+        dump.sourceSize = header.sourceSize;
+        dump.kinds = {reinterpret_cast<const TokenType*>(kinds), header.tokenCount};
+        dump.offsets = {reinterpret_cast<const std::uint32_t*>(offsets), header.tokenCount};
+        dump.lengths = {reinterpret_cast<const std::uint32_t*>(lengths), header.tokenCount};
+        dump.payloads = {reinterpret_cast<const std::uint32_t*>(payloads), header.tokenCount};
+
+        // Tokens run in order, cover the source and spell known keywords
+        // and operators. Only an end of file
+        // token marks skipped trivia, which may leave gaps between tokens.
+        const bool skippedTrivia = header.tokenCount != 0 && dump.kinds.back() == TokenType::EndOfFile;
+        bool valid = true;
+        std::uint64_t end = 0;
+        for (std::size_t i = 0; valid && i < header.tokenCount; ++i) {
+            valid = static_cast<std::size_t>(dump.kinds[i]) < TOKEN_TYPE_COUNT
+                && (skippedTrivia ? dump.offsets[i] >= end : dump.offsets[i] == end)
+                && (dump.kinds[i] != TokenType::EndOfFile || i + 1 == header.tokenCount)
+                && (dump.kinds[i] != TokenType::ReservedWord || (dump.payloads[i] != 0 && dump.payloads[i] <= static_cast<std::uint32_t>(Keyword::Template)))
+                && (dump.kinds[i] != TokenType::OperatorSequence || dump.payloads[i] <= static_cast<std::uint32_t>(OperatorKind::Arrow));
+            end = std::uint64_t{dump.offsets[i]} + dump.lengths[i];
+        }
+        if (!valid || end != header.sourceSize) {
+            std::cerr << "Error: Token dump does not describe its source.\n";
+            return -1;
+        }
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,96 @@
+/**
+ * @file token_dump.hpp
+ * 
+ * @brief Include file for the binary token dump format
+ */
+
+#ifndef TOKEN_DUMP_HPP
+#define TOKEN_DUMP_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include "tokenizer.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief Header at the start of every token dump
+     * 
+     * A dump is the header, then one `TokenType` byte per token padded to a
+     * multiple of four bytes, then one 32-bit offset per token, then one
+     * 32-bit length per token, then one 32-bit payload per token. The
+     * payload is the `Keyword` of reserved words, the `OperatorKind` of
+     * operators, the `NumberId` of numbers and the `SymbolId` of anything
+     * else. Every field is in host byte order, so the arrays can be used
+     * in place from a mapped file. Dumps are always a multiple of four
+     * bytes long and may be written back to back.
+     */
+    struct TokenDumpHeader {
+        std::array<char, 4> magic{'I', 'T', 'O', 'K'};
+        std::uint32_t version = 2;
+        std::uint32_t tokenCount = 0;
+        std::uint32_t sourceSize = 0;
+    };
+    static_assert(sizeof(TokenDumpHeader) == 16, "The dump header layout is fixed");
+
+    /**
+     * @brief The arrays of one token dump, borrowed from the bytes it was
+     *        read from
+     */
+    struct TokenDump {
+        std::uint32_t sourceSize = 0;
+        std::span<const TokenType> kinds;
+        std::span<const std::uint32_t> offsets;
+        std::span<const std::uint32_t> lengths;
+        std::span<const std::uint32_t> payloads;
+    };
+
+    /**
+     * @brief Provides the size in bytes of a dump of `tokenCount` tokens
+     * 
+     * @param[in] tokenCount The number of tokens in the dump
+     */
+    constexpr std::size_t tokenDumpSize(std::size_t tokenCount) {
+        return sizeof(TokenDumpHeader) + (tokenCount + 3) / 4 * 4 + tokenCount * 3 * sizeof(std::uint32_t);
+    }
+
+    /**
+     * @brief Writes tokens as one binary dump
+     * 
+     * @param[in] sourceSize Size of the source the tokens were lexed from.
+     *            Must be below 4 GiB.
+     * @param[in] tokens The tokens to write
+     * @param[in, out] out The stream to write to
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 The source is too large for the format
+     * @retval -2 Write Error
+     */
+    int writeTokenDump(std::size_t sourceSize, std::span<const TokenView> tokens, std::ostream& out);
+
+    /**
+     * @brief Reads the first dump in a byte range without copying it
+     * 
+     * A well formed dump has only known token kinds, keywords and operators,
+     * and its tokens run in order up to the end of the source. They leave
+     * no gaps, unless trivia was skipped and the last token is the
+     * `EndOfFile`.
+     * 
+     * @param[in] data Bytes of one or more dumps. Must be 4-byte aligned,
+     *            as mapped files are.
+     * @param[out] dump The dump's arrays, pointing into `data`
+     * @param[out] bytesUsed Size of the dump, where the next one starts
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 `data` is empty
+     * @retval -1 `data` does not start with a well formed dump
+     */
+    int readTokenDump(std::string_view data, TokenDump& dump, std::size_t& bytesUsed);
+
+}
+
+#endif
@@ -5,7 +5,12 @@
  */
 
 #include "tokenizer.hpp"
-#include "reserved_word_trie.hpp"
+#include "token_buffer.hpp"
+#include "reserved_words.hpp"
+#include "lexer_dfa.hpp"
+#include "char_scan.hpp"
+#include "source_map.hpp"
+#include "lexer_stats.hpp"
 #include <algorithm>
 #include <fstream>
 #include <iostream>
@@ -17,35 +22,42 @@
 using namespace std::literals::string_view_literals;
 
 namespace {
-    constexpr auto KEYWORD_TOKENS = {
-        /* Control Flow */
-        "if"sv, "else"sv, "while"sv, "for"sv, "return"sv, "do"sv,
-        /* ADTs */
-        "class"sv, "function"sv, "enum"sv, "signal"sv, "regex_t"sv,
-        /* Access Modifiers */
-        "public"sv, "private"sv, "protected"sv,
-        /* Primitive Types */
-        "int"sv, "string"sv, "bool"sv, "char"sv, "float"sv, "array"sv, "bits"sv,
-        /* Type Modifiers */
-        "const"sv, "static"sv, "ptr"sv, "ref"sv, "final"sv,
-        /* Compilation Unit Control */
-        "import"sv, "export"sv, "library"sv, "module"sv,
-        /* Semantic keywords */
-        "callback_t"sv, "continuation_t"sv, "template"sv
-    };
-    constexpr auto DELIMITER = ";,.(){}[]<>:\"'"sv;
-    constexpr auto WHITESPACE = " \n\t\r"sv;
-    constexpr auto DIGIT = "1234567890"sv;
-    constexpr auto NON_WHITESPACE_CHARACTER = 
-        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890!@#$%^&*_-+=|\\/?~`"sv;
     constexpr auto ESCAPE = "\\"sv;
 
+    /**
+     * @brief Whether tokens of a type are left out when skipping trivia
+     * 
+     * @param[in] type The token's type
+     */
+    constexpr bool isTrivia(imperium_lang::TokenType type) {
+        return type == imperium_lang::TokenType::Whitespace || type == imperium_lang::TokenType::Comment;
+    }
+
+    /**
+     * @brief Lexes the single token at the start of `text`, continuing an
+     *        earlier match of it on a prefix of `text`
+     * 
+     * @param[in] text The text to lex. Must not be empty.
+     * @param[in, out] match Where the earlier match stopped, or a default
+     *                 state. Left where this match stopped.
+     * @param[out] token The token found, with an offset of 0
+     * @return Whether a valid token starts `text`
+     */
+    bool lexResumedToken(std::string_view text, imperium_lang::TokenMatchState& match, imperium_lang::TokenView& token);
+
     /**
      * @brief Extracts the next token from the buffer
      * 
+     * The token's content is the first `bytesRead` bytes of `unprocessed`
+     * as it was before the call; no copy of the content is made.
+     * 
      * @param[in, out] unprocessed View of unprocessed data
+     * @param[in, out] match Where an earlier call on a shorter view of the
+     *                 same token stopped, or a default state. Left where
+     *                 this call stopped.
      * @param[out] type The extracted token's type
-     * @param[out] content The extracted token's content
+     * @param[out] keyword The reserved word the token spells, if any
+     * @param[out] op The operator the token spells, if any
      * @param[out] bytesRead Number of bytes read
      * @return Status code
      * @retval 0 Success
@@ -53,36 +65,118 @@ namespace {
      * @retval -1 Parse Error
      * @retval -2 Read Error
      */
-    int extractFirstToken(std::string_view& unprocessed, imperium_lang::TokenType& type, std::string& content, int& bytesRead);
+    int extractFirstToken(std::string_view& unprocessed, imperium_lang::TokenMatchState& match, imperium_lang::TokenType& type, imperium_lang::Keyword& keyword, imperium_lang::OperatorKind& op, std::size_t& bytesRead);
+
+    /**
+     * @brief How far lexing a source that is still being read has got
+     */
+    struct LexProgress {
+        std::size_t offset = 0; // Start of the first token not emitted yet
+        std::size_t validated = 0; // End of the text checked to be valid UTF-8
+        imperium_lang::TokenMatchState match{}; // How far the token at `offset` has been matched
+    };
 
     /**
-     * @brief Shifts unprocessed data to the start of a buffer, then refills
-     *        the buffer with the next data from the source file.
+     * @brief Extracts the tokens of the text read so far that no text read
+     *        later can change
      * 
-     * @param[in, out] unprocessed View of unprocessed data
-     * @param[in, out] buffer Buffer to fill
-     * @param[out] bytesRead Number of bytes read
-     * @param[in] source The source stream to read from
+     * Until the source is complete, a token ending closer to the end of
+     * the text than the lexer looks ahead is left for the next call, and
+     * so is a token that fails to lex, so it is only reported once the
+     * whole source is known to be valid UTF-8, as with a complete source.
+     * 
+     * @param[in] source The text read so far
+     * @param[in] complete Whether `source` is the whole source
+     * @param[in, out] progress Where the previous call for `source` stopped
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in] emit Called with each token as a `TokenView`
      * @return Status code
      * @retval 0 Success
-     * @retval 1 End of file reached
-     * @retval -1 Read Error
+     * @retval -1 Parse Error
      */
-    int refillBuffer(std::string_view& unprocessed, auto& buffer, int& bytesRead, auto& source);
+    int extractTokens(std::string_view source, bool complete, LexProgress& progress, imperium_lang::SymbolTable* symbols,
+        imperium_lang::NumberTable* numbers, imperium_lang::TriviaMode trivia, auto&& emit);
 
     /**
-     * @brief Determines if the next token is a comment
+     * @brief Extracts every token from a complete in-memory source
      * 
-     * @param[in] unprocessed View of unprocessed data
+     * @param[in] source The whole source to tokenize
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in] emit Called with each token as a `TokenView`
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
      */
-    bool isCommentFirst(const std::string_view& unprocessed);
+    int extractAllTokens(std::string_view source, imperium_lang::SymbolTable* symbols, imperium_lang::NumberTable* numbers,
+        imperium_lang::TriviaMode trivia, auto&& emit);
+
+    /**
+     * @brief Extracts every token from a source while the rest of it is
+     *        read
+     * 
+     * Each part the reader thread hands over is lexed while it reads the
+     * next, so reading a pipe overlaps with lexing it. Reading stops when
+     * the call returns, whatever its status.
+     * 
+     * @param[in, out] text The opened source
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in] emit Called with each token as a `TokenView`
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     * @retval -2 Read Error
+     */
+    int extractStreamedTokens(imperium_lang::SourceText& text, imperium_lang::SymbolTable* symbols, imperium_lang::NumberTable* numbers,
+        imperium_lang::TriviaMode trivia, auto&& emit);
+
+    /**
+     * @brief Lexes the single token at the start of `text`, continuing an
+     *        earlier match of it on a prefix of `text`
+     * 
+     * @param[in] text The text to lex. Must not be empty.
+     * @param[in, out] match Where the earlier match stopped, or a default
+     *                 state. Left where this match stopped.
+     * @param[out] token The token found, with an offset of 0
+     * @return Whether a valid token starts `text`
+     */
+    bool lexResumedToken(std::string_view text, imperium_lang::TokenMatchState& match, imperium_lang::TokenView& token) {
+
+        // Type and length come out of a single DFA pass over the token
+        const auto found = imperium_lang::matchToken(text, match);
+        if (found.type == imperium_lang::TokenType::Invalid) {
+            return false;
+        }
+        token = imperium_lang::TokenView{found.type, 0, found.length};
+        token.op = found.op;
+        if (found.type == imperium_lang::TokenType::CharSequence) {
+            token.keyword = imperium_lang::lookupKeyword(text.substr(0, found.length));
+            if (token.keyword != imperium_lang::Keyword::None) {
+                token.type = imperium_lang::TokenType::ReservedWord;
+            }
+        }
+
+        return true;
+    }
 
     /**
      * @brief Extracts the next token from the buffer
      * 
+     * The token's content is the first `bytesRead` bytes of `unprocessed`
+     * as it was before the call; no copy of the content is made.
+     * 
      * @param[in, out] unprocessed View of unprocessed data
+     * @param[in, out] match Where an earlier call on a shorter view of the
+     *                 same token stopped, or a default state. Left where
+     *                 this call stopped.
      * @param[out] type The extracted token's type
-     * @param[out] content The extracted token's content
+     * @param[out] keyword The reserved word the token spells, if any
+     * @param[out] op The operator the token spells, if any
      * @param[out] bytesRead Number of bytes read
      * @return Status code
      * @retval 0 Success
@@ -90,144 +184,208 @@ namespace {
      * @retval -1 Parse Error
      * @retval -2 Read Error
      */
-    int extractFirstToken(std::string_view& unprocessed, imperium_lang::TokenType& type, std::string& content, int& bytesRead) {
+    int extractFirstToken(std::string_view& unprocessed, imperium_lang::TokenMatchState& match, imperium_lang::TokenType& type, imperium_lang::Keyword& keyword, imperium_lang::OperatorKind& op, std::size_t& bytesRead) {
 
-        /** @todo Identify type of token to parse */
+        keyword = imperium_lang::Keyword::None;
+        op = imperium_lang::OperatorKind::None;
         if (unprocessed.empty()) {
             type = imperium_lang::TokenType::EndOfFile;
-        } else if (unprocessed.find_first_of(WHITESPACE) == 0) {
-            type = imperium_lang::TokenType::Whitespace;
-        } else if (unprocessed.find_first_of(DELIMITER) == 0) {
-            type = imperium_lang::TokenType::Delimiter;
-        } else if (isCommentFirst(unprocessed)) {
-            type = imperium_lang::TokenType::Comment;
-        } else if (unprocessed.find_first_of(DIGIT) == 0 && (unprocessed.find_first_not_of(DIGIT) == unprocessed.find_first_of(WHITESPACE) || unprocessed.find_first_not_of(DIGIT) == unprocessed.find_first_of(DELIMITER))) {
-            type = imperium_lang::TokenType::Number;
-        } else if (unprocessed.find_first_of(NON_WHITESPACE_CHARACTER) == 0) {
-            type = imperium_lang::TokenType::CharSequence;
-        } else {
+            bytesRead = 0;
+
+            return 1;
+        }
+
+        imperium_lang::TokenView token;
+        if (!lexResumedToken(unprocessed, match, token)) {
             type = imperium_lang::TokenType::Invalid;
+
+            return -1;
         }
+        type = token.type;
+        keyword = token.keyword;
+        op = token.op;
+        bytesRead = token.length;
+        unprocessed.remove_prefix(token.length);
 
-        /** @todo Parse token */
-        if (type == imperium_lang::TokenType::EndOfFile) {
-            content = "";
+        return 0;
+    }
 
-            return 1;
-        } else if (type == imperium_lang::TokenType::Whitespace) {
-            std::size_t end = unprocessed.find_first_not_of(WHITESPACE);
-            if (end == std::string_view::npos) {
-                end = unprocessed.size();
+    /**
+     * @brief Moves a location past some text
+     * 
+     * @param[in, out] location The location of the start of `text`
+     * @param[in] text The text to move past
+     */
+    void advanceLocation(imperium_lang::SourceLocation& location, std::string_view text) {
+        for (const char c : text) {
+            if (c == '\n') {
+                ++location.line;
+                location.column = 1;
+            } else if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+                ++location.column;
             }
-            content = std::string(unprocessed.substr(0, end));
-            unprocessed.remove_prefix(end);
-    
-            return 0;
-        } else if (type == imperium_lang::TokenType::Delimiter) {
-            content = std::string(unprocessed.substr(0, 1));
-            unprocessed.remove_prefix(1);
-    
-            return 0;
-        } else if (type == imperium_lang::TokenType::Comment) {
-            if (unprocessed[1] == '/') {
-                std::size_t end = unprocessed.find('\n');
-                if (end == std::string_view::npos) {
-                    end = unprocessed.size();
-                } else {
-                    --end;
-                }
-                content = std::string(unprocessed.substr(0, end));
-                unprocessed.remove_prefix(end);
-            } else if (unprocessed[1] == '*') {
-                std::size_t end = unprocessed.find("*/");
-                if (end == std::string_view::npos) {
-                    end = unprocessed.size();
-                }
-                content = std::string(unprocessed.substr(0, end + 2));
-                unprocessed.remove_prefix(end + 2);
+        }
+    }
+
+    /**
+     * @brief Extracts the tokens of the text read so far that no text read
+     *        later can change
+     * 
+     * Until the source is complete, a token ending closer to the end of
+     * the text than the lexer looks ahead is left for the next call, and
+     * so is a token that fails to lex, so it is only reported once the
+     * whole source is known to be valid UTF-8, as with a complete source.
+     * 
+     * @param[in] source The text read so far
+     * @param[in] complete Whether `source` is the whole source
+     * @param[in, out] progress Where the previous call for `source` stopped
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in] emit Called with each token as a `TokenView`
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int extractTokens(std::string_view source, bool complete, LexProgress& progress, imperium_lang::SymbolTable* symbols,
+        imperium_lang::NumberTable* numbers, imperium_lang::TriviaMode trivia, auto&& emit) {
+        IMPERIUM_STATS(
+            imperium_lang::PhaseTimer timer(imperium_lang::StatsPhase::Lex);
+            auto& stats = imperium_lang::lexerStats();
+        )
+
+        // Text read so far may end inside a UTF-8 sequence, so hold back a
+        // trailing lead byte and its continuation bytes
+        std::size_t end = source.size();
+        if (!complete) {
+            for (int held = 0; held < 3 && end > progress.validated && (static_cast<unsigned char>(source[end - 1]) & 0xC0) == 0x80; ++held) {
+                --end;
+            }
+            if (end > progress.validated && (static_cast<unsigned char>(source[end - 1]) & 0xC0) == 0xC0) {
+                --end;
             }
+        }
+        const std::size_t invalid = imperium_lang::findInvalidUtf8(source.substr(progress.validated, end - progress.validated));
+        if (invalid != std::string_view::npos) {
+            const auto location = imperium_lang::SourceMap(source).locate(progress.validated + invalid);
+            std::cerr << "Parse Error: Invalid UTF-8 at line " << location.line << ", column " << location.column << ".\n";
+            return -1;
+        }
+        progress.validated = end;
+        const std::string_view text = source.substr(0, end);
+        std::string_view unprocessed = text.substr(progress.offset);
+        while (true) {
+            imperium_lang::TokenType type;
+            imperium_lang::Keyword keyword;
+            imperium_lang::OperatorKind op;
+            std::size_t bytesRead;
+            const std::size_t offset = text.size() - unprocessed.size();
+            int extractStatus = extractFirstToken(unprocessed, progress.match, type, keyword, op, bytesRead);
+            if (extractStatus == -1 && complete) {
+                const auto location = imperium_lang::SourceMap(source).locate(offset);
+                std::cerr << "Parse Error: Failed to extract token at line " << location.line << ", column " << location.column << ".\n";
+                return -1;
+            } else if (extractStatus != 0 || (!complete && unprocessed.size() < imperium_lang::LEXER_LOOKAHEAD)) {
 
-            return 0;
-        } else if (type == imperium_lang::TokenType::Number) {
-            std::size_t end = unprocessed.find_first_not_of(DIGIT);
-            if (end == std::string_view::npos) {
-                end = unprocessed.size();
+                // The next call matches the held back token on from where
+                // this one stopped, so a long token is only read once
+                progress.offset = offset;
+                break;
             }
-            content = std::string(unprocessed.substr(0, end));
-            unprocessed.remove_prefix(end);
-    
-            return 0;
-        } else if (type == imperium_lang::TokenType::CharSequence) {
-            std::size_t end = unprocessed.find_first_not_of(NON_WHITESPACE_CHARACTER);
-            if (end == std::string_view::npos) {
-                end = unprocessed.size();
+            progress.match = imperium_lang::TokenMatchState{};
+            if (trivia == imperium_lang::TriviaMode::Skip && isTrivia(type)) {
+                continue;
             }
-            content = std::string(unprocessed.substr(0, end));
-            if (isReservedWord(content)) {
-                type = imperium_lang::TokenType::ReservedWord;
+            imperium_lang::SymbolId symbol = imperium_lang::NO_SYMBOL;
+            if (type == imperium_lang::TokenType::CharSequence && symbols != nullptr) {
+                symbol = symbols->intern(text.substr(offset, bytesRead));
             }
-            unprocessed.remove_prefix(end);
-    
-            return 0;
-        } else if (type == imperium_lang::TokenType::CharSequence) {
-            std::size_t end = std::min(unprocessed.find_first_of(WHITESPACE), unprocessed.find_first_of(DELIMITER));
-            if (end == std::string_view::npos) {
-                end = unprocessed.size();
+            imperium_lang::NumberId number = imperium_lang::NO_NUMBER;
+            if (type == imperium_lang::TokenType::Number && numbers != nullptr) {
+                number = numbers->add(text.substr(offset, bytesRead));
             }
-            content = std::string(unprocessed.substr(0, end));
-            unprocessed.remove_prefix(end);
-
-            return 0;
-        } else {
-            std::cerr << "Error: Invalid token type\n";
+            IMPERIUM_STATS(stats.countToken(type);)
+            emit(imperium_lang::TokenView{type, offset, bytesRead, keyword, symbol, op, number});
+        }
 
-            return -1;
+        // The end of file token carries the trailing trivia
+        if (complete && trivia == imperium_lang::TriviaMode::Skip) {
+            IMPERIUM_STATS(stats.countToken(imperium_lang::TokenType::EndOfFile);)
+            emit(imperium_lang::TokenView{imperium_lang::TokenType::EndOfFile, source.size(), 0});
         }
 
-        return -1; // Error case: should never reach here
+        return 0;
     }
 
     /**
-     * @brief Shifts unprocessed data to the start of a buffer, then refills
-     *        the buffer with the next data from the source file.
+     * @brief Extracts every token from a complete in-memory source
      * 
-     * @param[in, out] unprocessed View of unprocessed data
-     * @param[in, out] buffer Buffer to fill
-     * @param[out] bytesRead Number of bytes read
-     * @param[in] source The source stream to read from
+     * @param[in] source The whole source to tokenize
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in] emit Called with each token as a `TokenView`
      * @return Status code
      * @retval 0 Success
-     * @retval 1 End of file reached
-     * @retval -1 Read Error
+     * @retval -1 Parse Error
      */
-    int refillBuffer(std::string_view& unprocessed, auto& buffer, int& bytesRead, auto& source) {
-        std::copy(unprocessed.cbegin(), unprocessed.cend(), buffer.begin());
-        source.read(buffer.data() + unprocessed.size(), imperium_lang::BUFFER_SIZE - unprocessed.size());
-        bytesRead = source.gcount();
-        if (bytesRead <= 0) {
-            std::cerr << "Error: Failed to read from source file.\n";
-            return -1;
-        }
-        unprocessed = std::string_view(buffer.cbegin(), unprocessed.size() + bytesRead);
-        if (source.eof()) {
-            return 1;
-        }
+    int extractAllTokens(std::string_view source, imperium_lang::SymbolTable* symbols, imperium_lang::NumberTable* numbers,
+        imperium_lang::TriviaMode trivia, auto&& emit) {
+        LexProgress progress;
 
-        return 0;
+        return extractTokens(source, true, progress, symbols, numbers, trivia, emit);
     }
 
     /**
-     * @brief Determines if the next token is a comment
+     * @brief Extracts every token from a source while the rest of it is
+     *        read
      * 
-     * @param[in] unprocessed View of unprocessed data
+     * Each part the reader thread hands over is lexed while it reads the
+     * next, so reading a pipe overlaps with lexing it. Reading stops when
+     * the call returns, whatever its status.
+     * 
+     * @param[in, out] text The opened source
+     * @param[in, out] symbols Table to intern identifiers into. May be null.
+     * @param[in, out] numbers Table to decode numeric literals into. May be null.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in] emit Called with each token as a `TokenView`
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     * @retval -2 Read Error
      */
-    bool isCommentFirst(const std::string_view& unprocessed) {
-        return unprocessed.find("//") == 0 || unprocessed.find("/*") == 0;
+    int extractStreamedTokens(imperium_lang::SourceText& text, imperium_lang::SymbolTable* symbols, imperium_lang::NumberTable* numbers,
+        imperium_lang::TriviaMode trivia, auto&& emit) {
+        LexProgress progress;
+        while (true) {
+            const bool complete = text.complete();
+            const int status = extractTokens(text.view(), complete, progress, symbols, numbers, trivia, emit);
+            if (status != 0 || complete) {
+                text.stopReading();
+                return status;
+            }
+            if (text.readMore() == -2) {
+                return -2;
+            }
+        }
     }
 }
 
 namespace imperium_lang {
 
+    /**
+     * @brief Lexes the single token at the start of `text` without
+     *        reporting errors
+     * 
+     * @param[in] text The text to lex. Must not be empty.
+     * @param[out] token The token found, with an offset of 0
+     * @return Whether a valid token starts `text`
+     */
+    bool lexToken(std::string_view text, TokenView& token) {
+        TokenMatchState match{};
+        return lexResumedToken(text, match, token);
+    }
+
     /**
      * @brief Constructor
      * 
@@ -235,9 +393,23 @@ namespace imperium_lang {
      */
     Tokenizer::Tokenizer(const std::string& sourceFile) : sourceFile(sourceFile) {}
 
+    /**
+     * @brief Points the tokenizer at another source file, keeping its
+     *        buffers and interned symbols
+     * 
+     * @param[in] sourceFile The source file to tokenize next
+     */
+    void Tokenizer::setSourceFile(const std::string& sourceFile) {
+        this->sourceFile = sourceFile;
+        resetStream();
+    }
+
     /**
      * @brief Tokenize the source file
      * 
+     * Regular files are memory mapped and lexed in place. Other inputs,
+     * such as pipes, are lexed as they are read.
+     * 
      * @param[out] tokens The tokens extracted from the source file
      * @return Status code
      * @retval 0 Success
@@ -247,45 +419,279 @@ namespace imperium_lang {
     int Tokenizer::tokenize(std::vector<Token>& tokens) {
 
         tokens.clear();
-        std::ifstream source(sourceFile);
-        if (!source) {
-            std::cerr << "Error: Failed to open source file.\n";
+        resetStream();
+        if (sourceText.open(sourceFile, reader) != 0) {
             return -2;
         }
-        int totalBytesRead;
-        std::string_view unprocessed;
-        auto refillStatus = refillBuffer(unprocessed, buffer, totalBytesRead, source);
-        if (refillStatus == -1) {
-            std::cerr << "Error: Failed to read from source file.\n";
+        std::size_t end = 0;
+        const int status = extractStreamedTokens(sourceText, &symbolTable, nullptr, triviaMode, [&](const TokenView& token) {
+            const std::string_view source = sourceText.view();
+            tokens.emplace_back(token.type, std::string(token.text(source)), token.keyword, token.symbol,
+                std::string(source.substr(end, token.offset - end)), token.op,
+                token.type == TokenType::Number ? decodeNumber(token.text(source)) : NumberValue{});
+            end = token.offset + token.length;
+        });
+        sourceText.clear();
+
+        return status;
+    }
+
+    /**
+     * @brief Tokenize the source file without copying token text
+     * 
+     * The tokens borrow their text from `source()`, which stays valid until
+     * the next call to `tokenize` or until the tokenizer is destroyed.
+     * Sources that cannot be mapped are lexed as they are read.
+     * 
+     * @param[out] tokens The tokens extracted from the source file
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     * @retval -2 Read Error
+     */
+    int Tokenizer::tokenize(std::vector<TokenView>& tokens) {
+
+        tokens.clear();
+        resetStream();
+        if (sourceText.open(sourceFile, reader) != 0) {
             return -2;
         }
-        bool doneReading = refillStatus == 1;
+
+        return tokenize(sourceText, tokens, &symbolTable, triviaMode, &numberTable);
+    }
+
+    /**
+     * @brief Tokenize an in-memory source buffer without copying token text
+     * 
+     * @param[in] source The source buffer to tokenize. Must outlive `tokens`.
+     * @param[out] tokens The tokens extracted from the source buffer
+     * @param[in, out] symbols Table to intern identifiers into. If null,
+     *                 identifier tokens get `NO_SYMBOL`.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in, out] numbers Table to decode numeric literals into. If
+     *                 null, number tokens get `NO_NUMBER`.
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int Tokenizer::tokenize(std::string_view source, std::vector<TokenView>& tokens, SymbolTable* symbols, TriviaMode trivia,
+        NumberTable* numbers) {
+
+        tokens.clear();
+        return extractAllTokens(source, symbols, numbers, trivia, [&](const TokenView& token) {
+            tokens.push_back(token);
+        });
+    }
+
+    /**
+     * @brief Tokenize an opened source while the rest of it is read
+     * 
+     * @param[in, out] text The opened source. Complete when the call
+     *                 returns, or left as far as it was read on failure.
+     * @param[out] tokens The tokens extracted from the source
+     * @param[in, out] symbols Table to intern identifiers into. If null,
+     *                 identifier tokens get `NO_SYMBOL`.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in, out] numbers Table to decode numeric literals into. If
+     *                 null, number tokens get `NO_NUMBER`.
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     * @retval -2 Read Error
+     */
+    int Tokenizer::tokenize(SourceText& text, std::vector<TokenView>& tokens, SymbolTable* symbols, TriviaMode trivia,
+        NumberTable* numbers) {
+
+        tokens.clear();
+        return extractStreamedTokens(text, symbols, numbers, trivia, [&](const TokenView& token) {
+            tokens.push_back(token);
+        });
+    }
+
+    /**
+     * @brief Extracts the next token of the source file
+     * 
+     * @param[out] token The next token
+     * @return Status code
+     * @retval 0 Success
+     * @retval 1 End of file reached
+     * @retval -1 Parse Error
+     * @retval -2 Read Error
+     */
+    int Tokenizer::next(Token& token) {
+
+        if (!streaming) {
+            if (reader.open(sourceFile) != 0) {
+                std::cerr << "Error: Failed to open source file.\n";
+                return -2;
+            }
+            streaming = true;
+            doneReading = false;
+            unprocessed = {};
+            streamLocation = SourceLocation{1, 1};
+        }
+        token.trivia.clear();
+        bool windowFull = false;
         while (true) {
-            Token token;
-            int bytesRead;
-            int extractStatus = extractFirstToken(unprocessed, token.type, token.value, bytesRead);
+            if (unprocessed.size() < BLOCK_SIZE && !doneReading) {
+                const int readStatus = reader.extend(unprocessed);
+                if (readStatus == -2) {
+                    std::cerr << "Error: Failed to read from source file.\n";
+                    resetStream();
+                    return -2;
+                }
+                doneReading = readStatus == 1;
+            }
+            std::string_view rest = unprocessed;
+            std::size_t bytesRead;
+            TokenMatchState match{};
+            const int extractStatus = extractFirstToken(rest, match, token.type, token.keyword, token.op, bytesRead);
             if (extractStatus == -1) {
-                std::cerr << "Parse Error: Failed to extract token.\n";
+                std::cerr << "Parse Error: Failed to extract token at line " << streamLocation.line << ", column " << streamLocation.column << ".\n";
+                resetStream();
                 return -1;
-            } else if (extractStatus == -2) {
-                std::cerr << "Read Error: Failed to read from source file.\n";
-                return -2;
             } else if (extractStatus == 1) {
-                break;
-            } else if (extractStatus == 0) {
-                tokens.push_back(token);
+                token.value.clear();
+                token.symbol = NO_SYMBOL;
+
+                // When skipping trivia, the end of file is a token of its own
+                // that carries the trailing trivia
+                if (triviaMode == TriviaMode::Skip && !endEmitted) {
+                    token.type = TokenType::EndOfFile;
+                    token.keyword = Keyword::None;
+                    endEmitted = true;
+                    IMPERIUM_STATS(lexerStats().countToken(token.type);)
+                    return 0;
+                }
+                resetStream();
+                return 1;
             }
-            if (unprocessed.size() < BLOCK_SIZE && !doneReading) {
-                refillStatus = refillBuffer(unprocessed, buffer, totalBytesRead, source);
-                if (refillStatus == -1) {
+
+            // A token ending closer to the end of the window than the lexer
+            // looks ahead may continue past it, so read more and lex it again.
+            // Once the window cannot grow, the token would be cut in two.
+            if (rest.size() < LEXER_LOOKAHEAD && !doneReading) {
+                if (windowFull) {
+                    std::cerr << "Parse Error: Token longer than the streaming window at line " << streamLocation.line << ", column "
+                        << streamLocation.column << ".\n";
+                    resetStream();
+                    return -1;
+                }
+                const int readStatus = reader.extend(unprocessed);
+                if (readStatus == -2) {
                     std::cerr << "Error: Failed to read from source file.\n";
+                    resetStream();
                     return -2;
-                } else if (refillStatus == 1) {
-                    doneReading = true;
+                }
+                doneReading = readStatus == 1;
+                windowFull = readStatus == 2;
+                continue;
+            }
+            windowFull = false;
+            const std::string_view text = unprocessed.substr(0, bytesRead);
+
+            // Only words and comments can hold non-ASCII bytes, and no
+            // well formed sequence crosses out of them
+            if (token.type == TokenType::CharSequence || token.type == TokenType::Comment) {
+                const std::size_t invalid = findInvalidUtf8(text);
+                if (invalid != std::string_view::npos) {
+                    SourceLocation location = streamLocation;
+                    advanceLocation(location, text.substr(0, invalid));
+                    std::cerr << "Parse Error: Invalid UTF-8 at line " << location.line << ", column " << location.column << ".\n";
+                    resetStream();
+                    return -1;
                 }
             }
+            advanceLocation(streamLocation, text);
+            if (triviaMode == TriviaMode::Skip && isTrivia(token.type)) {
+                token.trivia.append(text);
+                unprocessed = rest;
+                continue;
+            }
+            token.value.assign(text);
+            token.symbol = token.type == TokenType::CharSequence ? symbolTable.intern(text) : NO_SYMBOL;
+            token.number = token.type == TokenType::Number ? decodeNumber(text) : NumberValue{};
+            unprocessed = rest;
+            IMPERIUM_STATS(lexerStats().countToken(token.type);)
+
+            return 0;
         }
+    }
 
-        return 0;
+    /**
+     * @brief Stops any stream `next` was reading so the next call starts
+     *        over at the beginning of the source file
+     */
+    void Tokenizer::resetStream() {
+        reader.close();
+        unprocessed = {};
+        streaming = false;
+        doneReading = false;
+        endEmitted = false;
+    }
+
+    /**
+     * @brief Loads the source file into `sourceText`
+     * 
+     * Any stream `next` was reading is stopped first, since the reader
+     * serves both.
+     * 
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int Tokenizer::loadSource() {
+        resetStream();
+
+        return sourceText.load(sourceFile, reader);
+    }
+
+    /**
+     * @brief Tokenize the source file into a struct-of-arrays buffer
+     * 
+     * @param[out] tokens The tokens extracted from the source file
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     * @retval -2 Read Error
+     */
+    int Tokenizer::tokenize(TokenBuffer& tokens) {
+
+        tokens.clear();
+        if (loadSource() != 0) {
+            return -2;
+        }
+
+        return tokenize(sourceText.view(), tokens, &symbolTable, triviaMode, &numberTable);
+    }
+
+    /**
+     * @brief Tokenize an in-memory source buffer into a struct-of-arrays
+     *        buffer
+     * 
+     * @param[in] source The source buffer to tokenize. Must be shorter
+     *            than 4 GiB and outlive `tokens`.
+     * @param[out] tokens The tokens extracted from the source buffer
+     * @param[in, out] symbols Table to intern identifiers into. If null,
+     *                 identifier tokens get `NO_SYMBOL`.
+     * @param[in] trivia Whether to emit whitespace and comments
+     * @param[in, out] numbers Table to decode numeric literals into. If
+     *                 null, number tokens get `NO_NUMBER`.
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int Tokenizer::tokenize(std::string_view source, TokenBuffer& tokens, SymbolTable* symbols, TriviaMode trivia,
+        NumberTable* numbers) {
+
+        tokens.clear();
+        if (source.size() > TokenBuffer::MAX_SOURCE_SIZE) {
+            std::cerr << "Error: Source is too large for a token buffer.\n";
+            return -1;
+        }
+
+        return extractAllTokens(source, symbols, numbers, trivia, [&](const TokenView& token) {
+            tokens.push(token);
+        });
     }
 }
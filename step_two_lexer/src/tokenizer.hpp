@@ -7,17 +7,30 @@
 #ifndef TOKENIZER_HPP
 #define TOKENIZER_HPP
 
-#include <array>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
+#include "number_table.hpp"
+#include "source_map.hpp"
+#include "source_text.hpp"
+#include "stream_reader.hpp"
+#include "reserved_words.hpp"
+#include "symbol_table.hpp"
 
 namespace imperium_lang {
 
     constexpr int BLOCK_SIZE = 4096;
     constexpr int BUFFER_SIZE = BLOCK_SIZE * 16 * 16;
 
-    enum TokenType {
+    // Bump whenever the tokens produced for the same source change, so
+    // cached results from older tokenizers are not reused
+    constexpr std::uint32_t TOKENIZER_VERSION = 5;
+
+    class TokenBuffer;
+
+    enum TokenType : std::uint8_t {
         CharSequence,
         Whitespace,
         Delimiter,
@@ -26,7 +39,9 @@ namespace imperium_lang {
         Invalid,
         EndOfFile,
         ReservedWord,
+        OperatorSequence,
     };
+    constexpr std::size_t TOKEN_TYPE_COUNT = static_cast<std::size_t>(OperatorSequence) + 1;
 
     /**
      * @brief Provides the string name of a `TokenType`
@@ -35,7 +50,7 @@ namespace imperium_lang {
      * @return The string name of the `TokenType`
      * @retval "invalid" The token is not a known TokenType
      */
-    constexpr std::string tokenTypeToString(TokenType type) {
+    constexpr std::string_view tokenTypeToString(TokenType type) {
         switch (type) {
             case CharSequence: return "char-sequence";
             case Number: return "number";
@@ -45,15 +60,90 @@ namespace imperium_lang {
             case Delimiter: return "delimiter";
             case Invalid: return "invalid";
             case ReservedWord: return "reserved-word";
+            case OperatorSequence: return "operator";
             default: return "invalid";
         }
     }
 
+    /**
+     * @brief Whether whitespace and comments are emitted as tokens
+     * 
+     * With `Skip`, no `Whitespace` or `Comment` tokens are emitted. The
+     * trivia before each token is the gap between it and the token before,
+     * and a zero-length `EndOfFile` token at the end of the source carries
+     * the trailing trivia, so the source can still be rebuilt exactly.
+     */
+    enum class TriviaMode : std::uint8_t {
+        Keep,
+        Skip,
+    };
+
     struct Token {
         TokenType type;
         std::string value;
+        Keyword keyword = Keyword::None; // Set for `ReservedWord` tokens
+        SymbolId symbol = NO_SYMBOL; // Set for `CharSequence` tokens
+        std::string trivia; // Leading whitespace and comments, set when trivia is skipped
+        OperatorKind op = OperatorKind::None; // Set for `OperatorSequence` tokens
+        NumberValue number{}; // Set for `Number` tokens
+    };
+
+    /**
+     * @brief A token that borrows its text from a source buffer
+     * 
+     * The token refers to its text by offset and length into the buffer it
+     * was extracted from. That buffer must be kept alive by the caller for
+     * as long as the token is used.
+     */
+    struct TokenView {
+        TokenType type;
+        std::size_t offset;
+        std::size_t length;
+        Keyword keyword = Keyword::None; // Set for `ReservedWord` tokens
+        SymbolId symbol = NO_SYMBOL; // Set for `CharSequence` tokens when interning
+        OperatorKind op = OperatorKind::None; // Set for `OperatorSequence` tokens
+        NumberId number = NO_NUMBER; // Set for `Number` tokens when decoding
+
+        /**
+         * @brief Provides the text of the token
+         * 
+         * @param[in] source The source buffer the token was extracted from
+         * @return View of the token's text within `source`
+         */
+        constexpr std::string_view text(std::string_view source) const {
+            return source.substr(offset, length);
+        }
     };
 
+    /**
+     * @brief Provides the whitespace and comments before a token
+     * 
+     * The trivia is found from the gap after the previous token, so it is
+     * empty unless the tokens were lexed with `TriviaMode::Skip`.
+     * 
+     * @param[in] tokens Tokens of `source`, in order
+     * @param[in] index Index of the token, below `tokens.size()`
+     * @param[in] source The source buffer the tokens were extracted from
+     * @return View of the token's leading trivia within `source`
+     */
+    constexpr std::string_view leadingTrivia(std::span<const TokenView> tokens, std::size_t index, std::string_view source) {
+        const std::size_t start = index == 0 ? 0 : tokens[index - 1].offset + tokens[index - 1].length;
+        return source.substr(start, tokens[index].offset - start);
+    }
+
+    /**
+     * @brief Lexes the single token at the start of `text` without
+     *        reporting errors
+     * 
+     * The lexer carries no state across token boundaries, so the result
+     * depends only on `text`. Symbols are not interned.
+     * 
+     * @param[in] text The text to lex. Must not be empty.
+     * @param[out] token The token found, with an offset of 0
+     * @return Whether a valid token starts `text`
+     */
+    bool lexToken(std::string_view text, TokenView& token);
+
     /**
      * @brief Tokenizer class
      * 
@@ -61,8 +151,35 @@ namespace imperium_lang {
      */
     class Tokenizer {
     private:
-        const std::string sourceFile;
-        std::array<char, BUFFER_SIZE> buffer{};
+        std::string sourceFile;
+        SourceText sourceText;
+        SymbolTable symbolTable;
+        NumberTable numberTable;
+        StreamReader reader;
+        std::string_view unprocessed;
+        SourceLocation streamLocation{1, 1}; // Location of the start of `unprocessed`
+        bool streaming = false;
+        bool doneReading = false;
+        bool endEmitted = false;
+        TriviaMode triviaMode = TriviaMode::Keep;
+
+        /**
+         * @brief Stops any stream `next` was reading so the next call starts
+         *        over at the beginning of the source file
+         */
+        void resetStream();
+
+        /**
+         * @brief Loads the source file into `sourceText`
+         * 
+         * Any stream `next` was reading is stopped first, since the reader
+         * serves both.
+         * 
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Read Error
+         */
+        int loadSource();
     public:
         /**
          * @brief Constructor
@@ -71,6 +188,22 @@ namespace imperium_lang {
          */
         Tokenizer(const std::string& sourceFile);
 
+        /**
+         * @brief Points the tokenizer at another source file, keeping its
+         *        buffers and interned symbols
+         * 
+         * @param[in] sourceFile The source file to tokenize next
+         */
+        void setSourceFile(const std::string& sourceFile);
+
+        /**
+         * @brief Chooses whether later calls emit whitespace and comments as
+         *        tokens
+         * 
+         * @param[in] mode The trivia mode. `Keep` unless set.
+         */
+        void setTriviaMode(TriviaMode mode) { triviaMode = mode; }
+
         /**
          * @brief Tokenize the source file
          * 
@@ -81,6 +214,132 @@ namespace imperium_lang {
          * @retval -2 Read Error
          */
         int tokenize(std::vector<Token>& tokens);
+
+        /**
+         * @brief Tokenize the source file without copying token text
+         * 
+         * The tokens borrow their text from `source()`, which stays valid until
+         * the next call to `tokenize` or until the tokenizer is destroyed.
+         * Sources that cannot be mapped are lexed as they are read.
+         * 
+         * @param[out] tokens The tokens extracted from the source file
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         * @retval -2 Read Error
+         */
+        int tokenize(std::vector<TokenView>& tokens);
+
+        /**
+         * @brief Extracts the next token of the source file
+         * 
+         * The file is read ahead on a reader thread into a ring of buffers,
+         * so only a bounded window of it is held in memory however large it
+         * is, and reading overlaps with lexing. The first call opens the
+         * file and the call that returns 1 closes it again. A token too
+         * long to fit the window is a parse error.
+         * `token.value` and `token.trivia` keep their capacity between calls.
+         * When skipping trivia, the last token is an `EndOfFile` token whose
+         * trivia is the end of the file.
+         * 
+         * @param[out] token The next token
+         * @return Status code
+         * @retval 0 Success
+         * @retval 1 End of file reached
+         * @retval -1 Parse Error
+         * @retval -2 Read Error
+         */
+        int next(Token& token);
+
+        /**
+         * @brief Tokenize the source file into a struct-of-arrays buffer
+         * 
+         * The tokens refer to `source()` by offset, as with `TokenView`s.
+         * 
+         * @param[out] tokens The tokens extracted from the source file
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         * @retval -2 Read Error
+         */
+        int tokenize(TokenBuffer& tokens);
+
+        /**
+         * @brief Provides the source text loaded by the last `tokenize` into
+         *        `TokenView`s
+         */
+        std::string_view source() const { return sourceText.view(); }
+
+        /**
+         * @brief Provides the identifiers interned by every `tokenize` call
+         *        on this tokenizer so far
+         */
+        const SymbolTable& symbols() const { return symbolTable; }
+
+        /**
+         * @brief Provides the numeric literals decoded by every `tokenize`
+         *        call on this tokenizer so far
+         */
+        const NumberTable& numbers() const { return numberTable; }
+
+        /**
+         * @brief Tokenize an in-memory source buffer without copying token text
+         * 
+         * @param[in] source The source buffer to tokenize. Must outlive `tokens`.
+         * @param[out] tokens The tokens extracted from the source buffer
+         * @param[in, out] symbols Table to intern identifiers into. If null,
+         *                 identifier tokens get `NO_SYMBOL`.
+         * @param[in] trivia Whether to emit whitespace and comments
+         * @param[in, out] numbers Table to decode numeric literals into. If
+         *                 null, number tokens get `NO_NUMBER`.
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         */
+        static int tokenize(std::string_view source, std::vector<TokenView>& tokens, SymbolTable* symbols = nullptr,
+            TriviaMode trivia = TriviaMode::Keep, NumberTable* numbers = nullptr);
+
+        /**
+         * @brief Tokenize an opened source while the rest of it is read
+         * 
+         * The text read so far is lexed while the reader thread reads the
+         * next part, so reading a pipe overlaps with lexing it. Tokens
+         * refer to the text by offset, so they stay valid as it grows.
+         * 
+         * @param[in, out] text The opened source. Complete when the call
+         *                 returns, or left as far as it was read on failure.
+         * @param[out] tokens The tokens extracted from the source
+         * @param[in, out] symbols Table to intern identifiers into. If null,
+         *                 identifier tokens get `NO_SYMBOL`.
+         * @param[in] trivia Whether to emit whitespace and comments
+         * @param[in, out] numbers Table to decode numeric literals into. If
+         *                 null, number tokens get `NO_NUMBER`.
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         * @retval -2 Read Error
+         */
+        static int tokenize(SourceText& text, std::vector<TokenView>& tokens, SymbolTable* symbols = nullptr,
+            TriviaMode trivia = TriviaMode::Keep, NumberTable* numbers = nullptr);
+
+        /**
+         * @brief Tokenize an in-memory source buffer into a struct-of-arrays
+         *        buffer
+         * 
+         * @param[in] source The source buffer to tokenize. Must be shorter
+         *            than 4 GiB and outlive `tokens`.
+         * @param[out] tokens The tokens extracted from the source buffer
+         * @param[in, out] symbols Table to intern identifiers into. If null,
+         *                 identifier tokens get `NO_SYMBOL`.
+         * @param[in] trivia Whether to emit whitespace and comments
+         * @param[in, out] numbers Table to decode numeric literals into. If
+         *                 null, number tokens get `NO_NUMBER`.
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         */
+        static int tokenize(std::string_view source, TokenBuffer& tokens, SymbolTable* symbols = nullptr,
+            TriviaMode trivia = TriviaMode::Keep, NumberTable* numbers = nullptr);
     };
 
 }
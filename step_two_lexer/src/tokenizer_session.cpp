@@ -0,0 +1,123 @@
+/**
+ * @file tokenizer_session.cpp
+ * 
+ * @brief Implementation file for reusable tokenizer sessions and their pool
+ */
+
+#include "tokenizer_session.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief Forgets the last file, keeping every buffer's memory
+     */
+    void TokenizerSession::reset() {
+        sourceText.clear();
+        tokenBuffer.clear();
+        symbolTable.clear();
+        numberTable.clear();
+    }
+
+    /**
+     * @brief Resets the session and loads a source file without lexing it
+     * 
+     * Sources that cannot be mapped are read ahead on the reader's thread.
+     * 
+     * @param[in] path The source file to load
+     * @return Status code
+     * @retval 0 Success
+     * @retval -2 Read Error
+     */
+    int TokenizerSession::load(const std::string& path) {
+        reset();
+
+        return sourceText.load(path, reader);
+    }
+
+    /**
+     * @brief Tokenizes the loaded source file
+     * 
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     */
+    int TokenizerSession::tokenize() {
+        symbolTable.clear();
+        numberTable.clear();
+
+        return Tokenizer::tokenize(sourceText.view(), tokenBuffer, &symbolTable, triviaMode, &numberTable);
+    }
+
+    /**
+     * @brief Resets the session, then loads and tokenizes a source file
+     * 
+     * @param[in] path The source file to tokenize
+     * @return Status code
+     * @retval 0 Success
+     * @retval -1 Parse Error
+     * @retval -2 Read Error
+     */
+    int TokenizerSession::tokenize(const std::string& path) {
+        if (load(path) != 0) {
+            return -2;
+        }
+
+        return tokenize();
+    }
+
+    SessionPool::Lease& SessionPool::Lease::operator=(Lease&& other) noexcept {
+        if (this != &other) {
+            if (session) {
+                pool->release(std::move(session));
+            }
+            pool = other.pool;
+            session = std::move(other.session);
+        }
+        return *this;
+    }
+
+    SessionPool::Lease::~Lease() {
+        if (session) {
+            pool->release(std::move(session));
+        }
+    }
+
+    /**
+     * @brief Takes an idle session, making one if there is none
+     * 
+     * @return The borrowed session
+     */
+    SessionPool::Lease SessionPool::acquire() {
+        {
+            std::lock_guard lock(mutex);
+            if (!idle.empty()) {
+                auto session = std::move(idle.back());
+                idle.pop_back();
+                return Lease(*this, std::move(session));
+            }
+        }
+
+        return Lease(*this, std::make_unique<TokenizerSession>());
+    }
+
+    /**
+     * @brief Resets a session and puts it back among the idle ones
+     * 
+     * @param[in] session The session to return
+     */
+    void SessionPool::release(std::unique_ptr<TokenizerSession> session) {
+        session->reset();
+        session->setTriviaMode(TriviaMode::Keep);
+        std::lock_guard lock(mutex);
+        idle.push_back(std::move(session));
+    }
+
+    /**
+     * @brief Provides the number of sessions waiting to be acquired
+     */
+    std::size_t SessionPool::idleCount() {
+        std::lock_guard lock(mutex);
+        return idle.size();
+    }
+
+}
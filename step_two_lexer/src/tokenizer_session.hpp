@@ -0,0 +1,171 @@
+/**
+ * @file tokenizer_session.hpp
+ * 
+ * @brief Include file for reusable tokenizer sessions and their pool
+ */
+
+#ifndef TOKENIZER_SESSION_HPP
+#define TOKENIZER_SESSION_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "number_table.hpp"
+#include "source_text.hpp"
+#include "stream_reader.hpp"
+#include "symbol_table.hpp"
+#include "token_buffer.hpp"
+#include "tokenizer.hpp"
+
+namespace imperium_lang {
+
+    /**
+     * @brief Tokenizes many source files in turn with one set of buffers
+     * 
+     * A session owns everything lexing a file needs: the reader for
+     * sources that cannot be mapped, the loaded source, the token buffer
+     * and the symbol and number tables. Loading a file resets them all but
+     * keeps their memory, so once a session has seen its largest file,
+     * further files allocate nothing. Only the results of the last file are held.
+     */
+    class TokenizerSession {
+    private:
+        StreamReader reader;
+        SourceText sourceText;
+        TokenBuffer tokenBuffer;
+        SymbolTable symbolTable;
+        NumberTable numberTable;
+        TriviaMode triviaMode = TriviaMode::Keep;
+    public:
+        TokenizerSession() = default;
+        TokenizerSession(const TokenizerSession&) = delete;
+        TokenizerSession& operator=(const TokenizerSession&) = delete;
+
+        /**
+         * @brief Chooses whether later calls emit whitespace and comments as
+         *        tokens
+         * 
+         * @param[in] mode The trivia mode. `Keep` unless set.
+         */
+        void setTriviaMode(TriviaMode mode) { triviaMode = mode; }
+
+        /**
+         * @brief Forgets the last file, keeping every buffer's memory
+         */
+        void reset();
+
+        /**
+         * @brief Resets the session and loads a source file without lexing it
+         * 
+         * @param[in] path The source file to load
+         * @return Status code
+         * @retval 0 Success
+         * @retval -2 Read Error
+         */
+        int load(const std::string& path);
+
+        /**
+         * @brief Tokenizes the loaded source file
+         * 
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         */
+        int tokenize();
+
+        /**
+         * @brief Resets the session, then loads and tokenizes a source file
+         * 
+         * @param[in] path The source file to tokenize
+         * @return Status code
+         * @retval 0 Success
+         * @retval -1 Parse Error
+         * @retval -2 Read Error
+         */
+        int tokenize(const std::string& path);
+
+        /**
+         * @brief Provides the text of the loaded file
+         */
+        std::string_view source() const { return sourceText.view(); }
+
+        /**
+         * @brief Provides the tokens of the loaded file
+         * 
+         * The tokens refer to `source()` by offset.
+         */
+        const TokenBuffer& tokens() const { return tokenBuffer; }
+
+        /**
+         * @brief Provides the identifiers interned from the loaded file
+         */
+        const SymbolTable& symbols() const { return symbolTable; }
+
+        /**
+         * @brief Provides the numeric literals decoded from the loaded file
+         */
+        const NumberTable& numbers() const { return numberTable; }
+    };
+
+    /**
+     * @brief Hands out idle sessions to worker threads and takes them back
+     * 
+     * Sessions are made on demand and never freed until the pool is, so a
+     * fixed set of workers settles on one session each.
+     */
+    class SessionPool {
+    private:
+        std::mutex mutex;
+        std::vector<std::unique_ptr<TokenizerSession>> idle;
+
+        /**
+         * @brief Resets a session and puts it back among the idle ones
+         * 
+         * @param[in] session The session to return
+         */
+        void release(std::unique_ptr<TokenizerSession> session);
+    public:
+        /**
+         * @brief A session borrowed from a pool, returned when destroyed
+         */
+        class Lease {
+        private:
+            SessionPool* pool = nullptr;
+            std::unique_ptr<TokenizerSession> session;
+        public:
+            Lease(SessionPool& pool, std::unique_ptr<TokenizerSession> session)
+                : pool(&pool), session(std::move(session)) {}
+            Lease(Lease&& other) noexcept = default;
+            Lease& operator=(Lease&& other) noexcept;
+            ~Lease();
+
+            TokenizerSession& operator*() const { return *session; }
+            TokenizerSession* operator->() const { return session.get(); }
+        };
+
+        SessionPool() = default;
+        SessionPool(const SessionPool&) = delete;
+        SessionPool& operator=(const SessionPool&) = delete;
+
+        /**
+         * @brief Takes an idle session, making one if there is none
+         * 
+         * The session comes with no file loaded and trivia kept. It must be
+         * returned, by destroying the lease, before the pool is destroyed.
+         * 
+         * @return The borrowed session
+         */
+        Lease acquire();
+
+        /**
+         * @brief Provides the number of sessions waiting to be acquired
+         */
+        std::size_t idleCount();
+    };
+
+}
+
+#endif
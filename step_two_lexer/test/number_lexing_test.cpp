@@ -0,0 +1,130 @@
+/**
+ * @file number_lexing_test.cpp
+ * 
+ * @brief Test checking how numeric literals and the words that look like
+ *        them are split into tokens, and what the literals decode to.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include "number_table.hpp"
+#include "tokenizer.hpp"
+
+namespace {
+
+    using imperium_lang::NumberKind;
+    using imperium_lang::TokenType;
+
+    struct ExpectedToken {
+        TokenType type;
+        std::string_view text;
+    };
+
+    struct LexingCase {
+        std::string_view source;
+        std::vector<ExpectedToken> tokens;
+    };
+
+    const std::vector<LexingCase> LEXING_CASES = {
+        // Integers, fractions and exponents
+        {"15", {{TokenType::Number, "15"}}},
+        {"1_000", {{TokenType::Number, "1_000"}}},
+        {"3.14", {{TokenType::Number, "3.14"}}},
+        {"1e5", {{TokenType::Number, "1e5"}}},
+        {"1.5e-3", {{TokenType::Number, "1.5e-3"}}},
+        {"0x1F", {{TokenType::Number, "0x1F"}}},
+        {"0b101", {{TokenType::Number, "0b101"}}},
+        {"1.5e3 x", {{TokenType::Number, "1.5e3"}, {TokenType::Whitespace, " "}, {TokenType::CharSequence, "x"}}},
+        // A word character after any number makes the whole run a word
+        {"15x", {{TokenType::CharSequence, "15x"}}},
+        {"1e5x", {{TokenType::CharSequence, "1e5x"}}},
+        {"3.14abc", {{TokenType::CharSequence, "3.14abc"}}},
+        {"1.5e-3x", {{TokenType::CharSequence, "1.5e-3x"}}},
+        {"0x1Fg", {{TokenType::CharSequence, "0x1Fg"}}},
+        {"1e5é", {{TokenType::CharSequence, "1e5é"}}},
+        // Prefixes and separators without digits after them are words
+        {"1e", {{TokenType::CharSequence, "1e"}}},
+        {"0x", {{TokenType::CharSequence, "0x"}}},
+        {"1_", {{TokenType::CharSequence, "1_"}}},
+        // Bytes that cannot continue a number end it
+        {"1.", {{TokenType::Number, "1"}, {TokenType::Delimiter, "."}}},
+        {"1e+", {{TokenType::CharSequence, "1e"}, {TokenType::OperatorSequence, "+"}}},
+        {"1.5;", {{TokenType::Number, "1.5"}, {TokenType::Delimiter, ";"}}},
+    };
+
+    struct DecodingCase {
+        std::string_view text;
+        NumberKind kind;
+        double value;
+    };
+
+    const std::vector<DecodingCase> DECODING_CASES = {
+        {"15", NumberKind::Int, 15},
+        {"1_000", NumberKind::Int, 1000},
+        {"2147483647", NumberKind::Int, 2147483647},
+        {"2147483648", NumberKind::OutOfRange, 0},
+        {"3.14", NumberKind::Float, 3.14},
+        {"1e5", NumberKind::Float, 1e5},
+        {"1.5e-3", NumberKind::Float, 1.5e-3},
+        {"0x1F", NumberKind::Bits, 31},
+        {"0b101", NumberKind::Bits, 5},
+    };
+
+    /**
+     * @brief Lexes one case and compares its tokens
+     * 
+     * @return Whether the tokens are as expected
+     */
+    bool lexesAsExpected(const LexingCase& test) {
+        std::vector<imperium_lang::TokenView> tokens{};
+        if (imperium_lang::Tokenizer::tokenize(test.source, tokens) != 0 || tokens.size() != test.tokens.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            if (tokens[i].type != test.tokens[i].type || tokens[i].text(test.source) != test.tokens[i].text) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Decodes one case and compares its value
+     * 
+     * @return Whether the value is as expected
+     */
+    bool decodesAsExpected(const DecodingCase& test) {
+        const imperium_lang::NumberValue value = imperium_lang::decodeNumber(test.text);
+        switch (value.kind) {
+            case NumberKind::Int: return test.kind == NumberKind::Int && value.integer == test.value;
+            case NumberKind::Float: return test.kind == NumberKind::Float && value.real == test.value;
+            case NumberKind::Bits: return test.kind == NumberKind::Bits && value.bits == test.value;
+            case NumberKind::OutOfRange: return test.kind == NumberKind::OutOfRange;
+        }
+        return false;
+    }
+}
+
+int main() {
+
+    std::size_t failures = 0;
+    for (const LexingCase& test : LEXING_CASES) {
+        if (!lexesAsExpected(test)) {
+            std::cout << "Unexpected tokens for \"" << test.source << "\"\n";
+            ++failures;
+        }
+    }
+    for (const DecodingCase& test : DECODING_CASES) {
+        if (!decodesAsExpected(test)) {
+            std::cout << "Unexpected value for \"" << test.text << "\"\n";
+            ++failures;
+        }
+    }
+
+    std::cout << "Checked " << LEXING_CASES.size() << " sources and " << DECODING_CASES.size() << " literals.\n";
+    std::cout << (failures == 0 ? "All numbers lex and decode as expected.\n" : "Numbers lex or decode wrongly.\n");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file parallel_lexer_test.cpp
+ * 
+ * @brief Test checking that lexing in parallel chunks gives the same tokens,
+ *        symbols and numbers as the serial lexer on random inputs.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "parallel_lexer.hpp"
+#include "tokenizer.hpp"
+
+namespace {
+
+    using imperium_lang::TokenView;
+    using imperium_lang::TriviaMode;
+
+    // Pieces the inputs are built from. Comments hold near-miss terminators
+    // and other tokens, so chunks often start inside a comment or quotes.
+    const std::vector<std::string> PIECES = {
+        " ", "\n", "\t", "word", "_x1", "if", "while", "continuation_t", "日本", "é",
+        "0", "42", "3.14", "1.5e-3", "0x1F", "0b101", "1_000", "15x",
+        "<<=", "==", "!=", "&&", "||", "::", "=>", "->", "+=", "/", "*", ">>", "<=>",
+        ";", "(", ")", "{", "}", "\"", "'", "\"quoted text\"", "'c'",
+        "/* comment */", "/* a * / b ** c */", "/* /* x = 1; */", "/**/", "/***/", "// line comment\n",
+        "/* if (x) { y <<= 0x1F; } \"*/",
+    };
+
+    const std::vector<std::string> COMMENT_FILLER = {"*", "/", "**", " / ", "x = y; ", "\n"};
+
+    /**
+     * @brief Builds a source of random pieces, with a long comment now and
+     *        then so a comment covers whole chunks
+     */
+    std::string randomSource(std::mt19937_64& random) {
+        std::string source;
+        const std::size_t pieces = random() % 400;
+        for (std::size_t i = 0; i < pieces; ++i) {
+            if (random() % 64 == 0) {
+                source += "/*";
+                const std::size_t filler = random() % 512;
+                for (std::size_t j = 0; j < filler; ++j)
+                    source += COMMENT_FILLER[random() % COMMENT_FILLER.size()];
+                source += "*/";
+            } else {
+                source += PIECES[random() % PIECES.size()];
+            }
+        }
+        return source;
+    }
+
+    bool sameToken(const TokenView& a, const TokenView& b) {
+        return a.type == b.type && a.offset == b.offset && a.length == b.length && a.keyword == b.keyword
+            && a.symbol == b.symbol && a.op == b.op && a.number == b.number;
+    }
+
+    /**
+     * @brief Lexes `source` serially and in parallel and compares the results
+     * 
+     * @return Whether both lexers agree
+     */
+    bool lexersAgree(std::string_view source, imperium_lang::WorkStealingPool& pool, std::size_t chunkSize, TriviaMode trivia) {
+        std::vector<TokenView> serialTokens{};
+        imperium_lang::SymbolTable serialSymbols{};
+        imperium_lang::NumberTable serialNumbers{};
+        const int serialStatus = imperium_lang::Tokenizer::tokenize(source, serialTokens, &serialSymbols, trivia, &serialNumbers);
+
+        std::vector<TokenView> parallelTokens{};
+        imperium_lang::SymbolTable parallelSymbols{};
+        imperium_lang::NumberTable parallelNumbers{};
+        const int parallelStatus = imperium_lang::tokenizeParallel(source, parallelTokens, &parallelSymbols, pool, chunkSize, trivia, &parallelNumbers);
+
+        if (serialStatus != parallelStatus)
+            return false;
+        if (serialStatus != 0)
+            return true;
+        if (serialTokens.size() != parallelTokens.size() || serialSymbols.size() != parallelSymbols.size()
+            || serialNumbers.size() != parallelNumbers.size())
+            return false;
+        for (std::size_t i = 0; i < serialTokens.size(); ++i) {
+            if (!sameToken(serialTokens[i], parallelTokens[i]))
+                return false;
+        }
+        for (imperium_lang::SymbolId id = 0; id < serialSymbols.size(); ++id) {
+            if (serialSymbols.name(id) != parallelSymbols.name(id))
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+
+    const std::size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+    std::mt19937_64 random(42);
+
+    // More threads than cores still interleaves speculation and stitching
+    imperium_lang::WorkStealingPool pool(4);
+    // Small chunks put boundaries inside comments, quotes and operators
+    const std::vector<std::size_t> chunkSizes = {1, 7, 64, 4096};
+
+    std::size_t failures = 0;
+    for (std::size_t i = 0; i < iterations && failures < 10; ++i) {
+        const std::string source = randomSource(random);
+        for (const std::size_t chunkSize : chunkSizes) {
+            for (const TriviaMode trivia : {TriviaMode::Keep, TriviaMode::Skip}) {
+                if (!lexersAgree(source, pool, chunkSize, trivia)) {
+                    std::cout << "Parallel lexing differs on input " << i << " of " << source.size() << " bytes with chunks of "
+                        << chunkSize << " bytes\n";
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    std::cout << "Compared serial and parallel lexing on " << iterations << " inputs.\n";
+    std::cout << (failures == 0 ? "All chunk sizes agree.\n" : "Parallel lexing disagrees.\n");
+
+    return failures == 0 ? 0 : 1;
+}
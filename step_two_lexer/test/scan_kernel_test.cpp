@@ -0,0 +1,113 @@
+/**
+ * @file scan_kernel_test.cpp
+ * 
+ * @brief Test checking that every run scanning kernel the CPU supports
+ *        returns the same results as the scalar kernel on random inputs.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "char_scan.hpp"
+
+namespace {
+
+    using imperium_lang::ScanKernel;
+
+    // Bytes the inputs are drawn from, weighted towards runs the kernels scan
+    const std::vector<std::string> PIECES = {
+        " ", "\t", "\n", "\r\n", "0", "7", "123", "a", "Z", "_", "word", "$",
+        "+", ";", "(", "/*", "\"", "é", "日本", "😀", "\x80", "\xC3", "\xE6\x97", "\xF0\x9F\x98", "\xFF", "\xC0\xAF",
+    };
+
+    /**
+     * @brief Results of every kernel on one input
+     */
+    struct ScanResults {
+        std::size_t whitespace;
+        std::size_t digits;
+        std::size_t word;
+        std::vector<std::size_t> newlines;
+        std::size_t invalidUtf8;
+
+        bool operator==(const ScanResults&) const = default;
+    };
+
+    ScanResults scanAll(std::string_view text) {
+        ScanResults results{};
+        results.whitespace = imperium_lang::scanWhitespace(text);
+        results.digits = imperium_lang::scanDigits(text);
+        results.word = imperium_lang::scanWord(text);
+        imperium_lang::findNewlines(text, results.newlines);
+        results.invalidUtf8 = imperium_lang::findInvalidUtf8(text);
+        return results;
+    }
+
+    /**
+     * @brief Builds an input of runs of one piece, so runs cross vector widths
+     */
+    std::string randomInput(std::mt19937_64& random) {
+        std::string text;
+        const std::size_t runs = random() % 12;
+        for (std::size_t run = 0; run < runs; ++run) {
+            const std::string& piece = PIECES[random() % PIECES.size()];
+            const std::size_t repeats = 1 + random() % (random() % 4 == 0 ? 80 : 6);
+            for (std::size_t i = 0; i < repeats; ++i)
+                text += piece;
+        }
+        return text;
+    }
+
+    const char* kernelName(ScanKernel kernel) {
+        switch (kernel) {
+            case ScanKernel::Scalar: return "scalar";
+            case ScanKernel::SSE2: return "sse2";
+            case ScanKernel::AVX2: return "avx2";
+        }
+        return "unknown";
+    }
+}
+
+int main(int argc, char** argv) {
+
+    const std::size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::mt19937_64 random(42);
+
+    // Only kernels the CPU runs are compared; others fall back to scalar
+    std::vector<ScanKernel> kernels{};
+    for (const ScanKernel kernel : {ScanKernel::SSE2, ScanKernel::AVX2}) {
+        if (imperium_lang::selectScanKernel(kernel) == kernel)
+            kernels.push_back(kernel);
+    }
+
+    std::size_t failures = 0;
+    for (std::size_t i = 0; i < iterations && failures < 10; ++i) {
+
+        // Scan from an unaligned start inside a larger buffer
+        const std::string buffer = randomInput(random);
+        const std::size_t start = buffer.empty() ? 0 : random() % (buffer.size() + 1);
+        const std::string_view text = std::string_view(buffer).substr(start);
+
+        imperium_lang::selectScanKernel(ScanKernel::Scalar);
+        const ScanResults expected = scanAll(text);
+        for (const ScanKernel kernel : kernels) {
+            imperium_lang::selectScanKernel(kernel);
+            if (!(scanAll(text) == expected)) {
+                std::cout << kernelName(kernel) << " differs from scalar on input " << i << " of " << text.size() << " bytes\n";
+                ++failures;
+            }
+        }
+    }
+    imperium_lang::selectScanKernel(ScanKernel::AVX2);
+
+    std::cout << "Compared scalar against";
+    for (const ScanKernel kernel : kernels)
+        std::cout << " " << kernelName(kernel);
+    std::cout << (kernels.empty() ? " nothing" : "") << " on " << iterations << " inputs.\n";
+    std::cout << (failures == 0 ? "All kernels agree.\n" : "Kernels disagree.\n");
+
+    return failures == 0 ? 0 : 1;
+}